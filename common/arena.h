@@ -0,0 +1,77 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdlib.h>
+
+// Bump (arena) allocator shared by the node-based builders
+// (problem_1 adjacency nodes, problem_3 roads, problem_5 Huffman nodes).
+//
+// Nodes are carved out of large blocks by bumping a pointer, so an
+// allocation is a few instructions and consecutive nodes sit next to each
+// other in memory. There is no per-node free: everything is released at
+// once with arenaRelease() when the owning graph or tree is destroyed.
+
+#define ARENA_DEFAULT_BLOCK_SIZE 4096
+#define ARENA_MAX_BLOCK_SIZE (16u << 20)
+
+typedef struct ArenaBlock {
+    struct ArenaBlock* next;
+    size_t used;
+    size_t capacity;
+    max_align_t data[];
+} ArenaBlock;
+
+typedef struct Arena {
+    ArenaBlock* head;        // Block currently being filled
+    size_t nextBlockSize;    // Size of the next block (doubles up to ARENA_MAX_BLOCK_SIZE)
+    size_t bytesAllocated;   // Total bytes handed out
+} Arena;
+
+// Function to initialize an empty arena (no memory is reserved yet)
+static inline void arenaInit(Arena* arena, size_t firstBlockSize) {
+    arena->head = NULL;
+    arena->nextBlockSize = firstBlockSize ? firstBlockSize : ARENA_DEFAULT_BLOCK_SIZE;
+    arena->bytesAllocated = 0;
+}
+
+// Function to allocate size bytes aligned to alignment from the arena
+// (NULL if out of memory); alignment is a power of two no larger than
+// _Alignof(max_align_t), normally _Alignof of the type being allocated
+static inline void* arenaAlloc(Arena* arena, size_t size, size_t alignment) {
+    ArenaBlock* block = arena->head;
+    size_t offset = block ? (block->used + alignment - 1) & ~(alignment - 1) : 0;
+    if (block == NULL || offset > block->capacity || block->capacity - offset < size) {
+        size_t capacity = arena->nextBlockSize;
+        while (capacity < size) capacity *= 2;
+
+        block = (ArenaBlock*)malloc(sizeof(ArenaBlock) + capacity);
+        if (block == NULL) return NULL;
+        block->next = arena->head;
+        block->used = 0;
+        block->capacity = capacity;
+        arena->head = block;
+        offset = 0;
+
+        if (arena->nextBlockSize < ARENA_MAX_BLOCK_SIZE) arena->nextBlockSize *= 2;
+    }
+
+    void* memory = (unsigned char*)block->data + offset;
+    block->used = offset + size;
+    arena->bytesAllocated += size;
+    return memory;
+}
+
+// Function to free every block of the arena; the arena can be reused afterwards
+static inline void arenaRelease(Arena* arena) {
+    ArenaBlock* block = arena->head;
+    while (block != NULL) {
+        ArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->head = NULL;
+    arena->bytesAllocated = 0;
+}
+
+#endif
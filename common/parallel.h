@@ -0,0 +1,81 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// Fork-join helpers shared by the multithreaded phases
+// (problem_1 CSR build, SCC and PageRank, problem_2 parallel selection,
+// problem_3 traversal levels).
+//
+// runParallel() starts a team of threads, runs the same task on each with
+// its thread id, and returns once all of them are done. Work is divided by
+// the tasks themselves, usually into contiguous chunks with chunkRange().
+
+// Function to pick a default worker count (one per online CPU)
+static inline int defaultThreadCount(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (int)cpus : 1;
+#endif
+}
+
+// Work function run by each worker of runParallel()
+typedef void (*ParallelTask)(int threadId, int numThreads, void* arg);
+
+struct ParallelWorker {
+    ParallelTask task;
+    void* arg;
+    int threadId;
+    int numThreads;
+};
+
+static inline void* parallelWorkerMain(void* param) {
+    struct ParallelWorker* worker = (struct ParallelWorker*)param;
+    worker->task(worker->threadId, worker->numThreads, worker->arg);
+    return NULL;
+}
+
+// Function to run task on numThreads threads and wait for all of them
+// Thread 0 is the calling thread, so numThreads == 1 spawns nothing.
+static inline void runParallel(int numThreads, ParallelTask task, void* arg) {
+    if (numThreads < 1) numThreads = 1;
+    pthread_t* threads = (pthread_t*)malloc(numThreads * sizeof(pthread_t));
+    struct ParallelWorker* workers = (struct ParallelWorker*)malloc(numThreads * sizeof(struct ParallelWorker));
+    
+    for (int t = 0; t < numThreads; t++) {
+        workers[t].task = task;
+        workers[t].arg = arg;
+        workers[t].threadId = t;
+        workers[t].numThreads = numThreads;
+    }
+    for (int t = 1; t < numThreads; t++) {
+        pthread_create(&threads[t], NULL, parallelWorkerMain, &workers[t]);
+    }
+    parallelWorkerMain(&workers[0]);
+    for (int t = 1; t < numThreads; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    
+    free(workers);
+    free(threads);
+}
+
+// Function to split [0, total) into numThreads contiguous chunks
+static inline void chunkRange(size_t total, int threadId, int numThreads, size_t* begin, size_t* end) {
+    *begin = total * (size_t)threadId / numThreads;
+    *end = total * (size_t)(threadId + 1) / numThreads;
+}
+
+#endif
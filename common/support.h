@@ -0,0 +1,25 @@
+#ifndef SUPPORT_H
+#define SUPPORT_H
+
+#include <time.h>
+
+// Small helpers shared by the benchmarks and generators of every problem:
+// a wall-clock timer and the seeded splitmix64 generator, so a given seed
+// produces the same inputs in each program.
+
+// Function to return the current wall-clock time in seconds
+static inline double nowSeconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Function to advance a splitmix64 generator and return its next value
+static inline unsigned long long nextRandom(unsigned long long* state) {
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+#endif
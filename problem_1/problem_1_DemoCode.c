@@ -1,109 +1,652 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/stat.h>
 
-#define MAX_USERS 100
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
 
-// Structure for adjacency list node
+#include "../common/arena.h"
+#include "../common/parallel.h"
+#include "../common/support.h"
+
+// A read-only file mapped into memory (read into a buffer where mmap is unavailable)
+struct MappedFile {
+    void* data;
+    size_t length;
+};
+
+// Structure for adjacency list node (incremental builder)
 struct AdjListNode {
     int dest;
     struct AdjListNode* next;
 };
 
-// Structure for adjacency list
+// Structure for adjacency list (incremental builder)
 struct AdjList {
     struct AdjListNode* head;
 };
 
 // Structure for the graph
+// Follow edges are stored in compressed sparse row (CSR) form: the users
+// followed by user u are followees[rowOffsets[u]] .. followees[rowOffsets[u + 1] - 1].
+// Edges added one at a time with addEdge() wait in per-user linked lists
+// until compactGraph() merges them into the CSR arrays.
 struct Graph {
     int numUsers;
-    struct AdjList* array;
+    size_t numEdges;         // Edges stored in CSR form
+    size_t* rowOffsets;      // numUsers + 1 entries
+    int* followees;          // numEdges entries
+    size_t pendingEdges;     // Edges waiting in the incremental lists
+    struct AdjList* array;   // Incremental (linked-list) builder, allocated on first addEdge()
+    Arena nodeArena;         // Storage for the incremental builder's nodes
+    struct MappedFile image; // Cached CSR image the arrays point into (data == NULL if heap-owned)
 };
 
-// Global variables for DFS
-int discovery[MAX_USERS];
-int finish[MAX_USERS];
-int visited[MAX_USERS];
-int time_counter = 0;
+// Largest graph the loaders accept: DFS discovery/finish timestamps run up
+// to 2 * numUsers and are stored as int
+#define MAX_USERS (INT_MAX / 2)
+
+// State of one DFS traversal, sized to the graph
+// All traversal state lives here rather than in globals, so several
+// traversals can run at once (e.g. on different threads) against one
+// shared read-only graph.
+struct DFSContext {
+    int numUsers;
+    int* discovery;
+    int* finish;
+    unsigned char* visited;
+    int timeCounter;
+    int verbose;             // Print every discovery/finish step (off by default)
+    
+    // Explicit DFS stack: a user and the next CSR edge to scan for that user
+    int* stackUsers;
+    size_t* stackEdges;
+    int stackTop;
+    
+    // Counters for profiling
+    size_t edgesScanned;
+    int maxStackDepth;
+};
 
-// Function to create a new adjacency list node
-struct AdjListNode* newAdjListNode(int dest) {
-    struct AdjListNode* newNode = (struct AdjListNode*)malloc(sizeof(struct AdjListNode));
+// Function to create a new adjacency list node in the graph's node arena
+struct AdjListNode* newAdjListNode(Arena* arena, int dest) {
+    struct AdjListNode* newNode = (struct AdjListNode*)arenaAlloc(arena, sizeof(struct AdjListNode), _Alignof(struct AdjListNode));
     newNode->dest = dest;
     newNode->next = NULL;
     return newNode;
 }
 
-// Function to create a graph with n vertices
+// Function to create an empty graph with n vertices
 struct Graph* createGraph(int numUsers) {
     struct Graph* graph = (struct Graph*)malloc(sizeof(struct Graph));
     graph->numUsers = numUsers;
-    graph->array = (struct AdjList*)malloc(numUsers * sizeof(struct AdjList));
+    graph->numEdges = 0;
+    graph->rowOffsets = (size_t*)calloc((size_t)numUsers + 1, sizeof(size_t));
+    graph->followees = NULL;
+    graph->pendingEdges = 0;
+    graph->array = NULL;
+    arenaInit(&graph->nodeArena, 0);
+    graph->image.data = NULL;
+    graph->image.length = 0;
+    return graph;
+}
+
+// Function to build a CSR graph from a bulk edge list (src[i] follows dest[i])
+// Counting sort: count out-degrees, prefix-sum them into row offsets, then
+// scatter each edge into its row. Two passes over the edges, no per-edge malloc.
+struct Graph* createGraphFromEdges(int numUsers, const int* src, const int* dest, size_t numEdges) {
+    for (size_t e = 0; e < numEdges; e++) {
+        if (src[e] < 0 || src[e] >= numUsers || dest[e] < 0 || dest[e] >= numUsers) {
+            fprintf(stderr, "Edge %zu (%d -> %d) is out of range for %d users\n",
+                    e, src[e], dest[e], numUsers);
+            return NULL;
+        }
+    }
+    
+    struct Graph* graph = createGraph(numUsers);
+    size_t* offsets = graph->rowOffsets;
+    
+    // Count out-degree of each user into offsets[u + 1]
+    for (size_t e = 0; e < numEdges; e++) {
+        offsets[src[e] + 1]++;
+    }
     
-    // Initialize each adjacency list as empty
-    for (int i = 0; i < numUsers; ++i) {
-        graph->array[i].head = NULL;
+    // Prefix sum turns degrees into row start positions
+    for (int u = 0; u < numUsers; u++) {
+        offsets[u + 1] += offsets[u];
     }
     
+    // Scatter edges into their rows (stable: keeps input order within a row)
+    size_t* cursor = (size_t*)malloc(((size_t)numUsers + 1) * sizeof(size_t));
+    memcpy(cursor, offsets, ((size_t)numUsers + 1) * sizeof(size_t));
+    graph->followees = (int*)malloc((numEdges ? numEdges : 1) * sizeof(int));
+    for (size_t e = 0; e < numEdges; e++) {
+        graph->followees[cursor[src[e]]++] = dest[e];
+    }
+    free(cursor);
+    
+    graph->numEdges = numEdges;
     return graph;
 }
 
 // Function to add an edge to the directed graph (A follows B)
+// The edge goes into the incremental builder; call compactGraph() before traversing.
 void addEdge(struct Graph* graph, int src, int dest) {
+    if (graph->array == NULL) {
+        // Initialize each adjacency list as empty
+        graph->array = (struct AdjList*)calloc(graph->numUsers, sizeof(struct AdjList));
+    }
+    
     // Add edge from src to dest
-    struct AdjListNode* newNode = newAdjListNode(dest);
+    struct AdjListNode* newNode = newAdjListNode(&graph->nodeArena, dest);
     newNode->next = graph->array[src].head;
     graph->array[src].head = newNode;
+    graph->pendingEdges++;
 }
 
-// DFS function with timestamps
-void DFS(struct Graph* graph, int user) {
-    // Mark current user as visited and record discovery time
-    visited[user] = 1;
-    discovery[user] = ++time_counter;
-    
-    printf("User %d: Discovered at time %d\n", user, discovery[user]);
-    
-    // Traverse all adjacent users (users that current user follows)
-    struct AdjListNode* temp = graph->array[user].head;
-    while (temp) {
-        int adjUser = temp->dest;
-        if (!visited[adjUser]) {
-            printf("  User %d follows User %d (exploring...)\n", user, adjUser);
-            DFS(graph, adjUser);
-        } else {
-            printf("  User %d follows User %d (already visited)\n", user, adjUser);
+// Function to release the CSR arrays (heap-owned or mapped from a cached image)
+static void unmapFile(struct MappedFile* file);
+
+static void releaseCSRArrays(struct Graph* graph) {
+    if (graph->image.data) {
+        unmapFile(&graph->image);
+    } else {
+        free(graph->rowOffsets);
+        free(graph->followees);
+    }
+    graph->rowOffsets = NULL;
+    graph->followees = NULL;
+}
+
+// Function to merge the incremental linked lists into the CSR arrays
+// Pending edges of a user come first (newest first, as in the linked list),
+// followed by the edges already in CSR form.
+void compactGraph(struct Graph* graph) {
+    if (graph->pendingEdges == 0) return;
+    
+    int n = graph->numUsers;
+    size_t total = graph->numEdges + graph->pendingEdges;
+    size_t* offsets = (size_t*)malloc(((size_t)n + 1) * sizeof(size_t));
+    int* followees = (int*)malloc(total * sizeof(int));
+    
+    size_t pos = 0;
+    for (int u = 0; u < n; u++) {
+        offsets[u] = pos;
+        
+        for (struct AdjListNode* temp = graph->array[u].head; temp; temp = temp->next) {
+            followees[pos++] = temp->dest;
+        }
+        graph->array[u].head = NULL;
+        
+        for (size_t e = graph->rowOffsets[u]; e < graph->rowOffsets[u + 1]; e++) {
+            followees[pos++] = graph->followees[e];
+        }
+    }
+    offsets[n] = pos;
+    
+    // Every pending node has been copied: drop them all at once
+    arenaRelease(&graph->nodeArena);
+    releaseCSRArrays(graph);
+    graph->rowOffsets = offsets;
+    graph->followees = followees;
+    graph->numEdges = total;
+    graph->pendingEdges = 0;
+}
+
+// Function to free the graph, including any edges still in the incremental lists
+void freeGraph(struct Graph* graph) {
+    arenaRelease(&graph->nodeArena);
+    free(graph->array);
+    releaseCSRArrays(graph);
+    free(graph);
+}
+
+// ===================== BINARY EDGE-LIST INGESTION =====================
+//
+// Edge file layout (native byte order):
+//   EdgeFileHeader, then numEdges (src, dest) pairs of idBytes-wide unsigned ids
+//
+// CSR image layout (written by saveCSRImage, mapped back by loadCSRImage):
+//   CSRImageHeader, then uint64 rowOffsets[numUsers + 1], then int32 followees[numEdges]
+// The image records the size and modification time of the edge file it was
+// built from, so a stale image is rebuilt instead of being trusted.
+
+#define EDGE_FILE_MAGIC "SGEDGES"
+#define CSR_IMAGE_MAGIC "SGCSRIM"
+#define EDGE_FILE_VERSION 1
+#define CSR_IMAGE_VERSION 1
+
+struct EdgeFileHeader {
+    char magic[8];           // EDGE_FILE_MAGIC
+    uint32_t version;        // EDGE_FILE_VERSION
+    uint32_t idBytes;        // 4 (u32 ids) or 8 (u64 ids)
+    uint64_t numUsers;
+    uint64_t numEdges;
+};
+
+struct CSRImageHeader {
+    char magic[8];           // CSR_IMAGE_MAGIC
+    uint32_t version;        // CSR_IMAGE_VERSION
+    uint32_t reserved;
+    uint64_t numUsers;
+    uint64_t numEdges;
+    uint64_t sourceBytes;    // Size of the edge file the image was built from
+    int64_t sourceMtime;     // Modification time of that edge file
+};
+
+// Function to map a whole file read-only; returns 0 on success
+static int mapFile(const char* path, struct MappedFile* file) {
+    file->data = NULL;
+    file->length = 0;
+#ifdef _WIN32
+    // No mmap: read the file into one buffer instead
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return -1;
+    fseek(fp, 0, SEEK_END);
+    long length = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (length <= 0) { fclose(fp); return -1; }
+    file->data = malloc((size_t)length);
+    if (!file->data || fread(file->data, 1, (size_t)length, fp) != (size_t)length) {
+        free(file->data);
+        file->data = NULL;
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+    file->length = (size_t)length;
+    return 0;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) { close(fd); return -1; }
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return -1;
+    file->data = data;
+    file->length = (size_t)st.st_size;
+    return 0;
+#endif
+}
+
+static void unmapFile(struct MappedFile* file) {
+    if (!file->data) return;
+#ifdef _WIN32
+    free(file->data);
+#else
+    munmap(file->data, file->length);
+#endif
+    file->data = NULL;
+    file->length = 0;
+}
+
+// Shared state for the parallel CSR build from a mapped edge list
+struct EdgeListBuild {
+    const unsigned char* edges;   // First (src, dest) pair
+    uint32_t idBytes;
+    size_t numEdges;
+    int numUsers;
+    size_t* rowOffsets;           // Degree counts, then row starts
+    size_t* cursor;               // Next free slot in each row during the scatter
+    int* followees;
+    size_t* blockSums;            // Per-thread totals for the parallel prefix sum
+    int invalid;                  // Set (atomically) if any id is out of range
+};
+
+static inline uint64_t edgeEndpoint(const struct EdgeListBuild* build, size_t e, int which) {
+    if (build->idBytes == 4) {
+        return ((const uint32_t*)build->edges)[2 * e + which];
+    }
+    return ((const uint64_t*)build->edges)[2 * e + which];
+}
+
+// Phase 1: validate ids and count out-degrees into rowOffsets[u + 1]
+static void countDegreesTask(int threadId, int numThreads, void* arg) {
+    struct EdgeListBuild* build = (struct EdgeListBuild*)arg;
+    size_t begin, end;
+    chunkRange(build->numEdges, threadId, numThreads, &begin, &end);
+    
+    for (size_t e = begin; e < end; e++) {
+        uint64_t src = edgeEndpoint(build, e, 0);
+        uint64_t dest = edgeEndpoint(build, e, 1);
+        if (src >= (uint64_t)build->numUsers || dest >= (uint64_t)build->numUsers) {
+            __atomic_store_n(&build->invalid, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        __atomic_fetch_add(&build->rowOffsets[src + 1], 1, __ATOMIC_RELAXED);
+    }
+}
+
+// Phase 2a: each thread sums its block of degrees
+static void blockSumTask(int threadId, int numThreads, void* arg) {
+    struct EdgeListBuild* build = (struct EdgeListBuild*)arg;
+    size_t begin, end;
+    chunkRange((size_t)build->numUsers, threadId, numThreads, &begin, &end);
+    
+    size_t sum = 0;
+    for (size_t u = begin; u < end; u++) {
+        sum += build->rowOffsets[u + 1];
+    }
+    build->blockSums[threadId] = sum;
+}
+
+// Phase 2b: each thread turns its block into row starts, seeded with the
+// total of all earlier blocks, and copies them into the scatter cursors
+static void blockPrefixTask(int threadId, int numThreads, void* arg) {
+    struct EdgeListBuild* build = (struct EdgeListBuild*)arg;
+    size_t begin, end;
+    chunkRange((size_t)build->numUsers, threadId, numThreads, &begin, &end);
+    
+    size_t running = 0;
+    for (int t = 0; t < threadId; t++) {
+        running += build->blockSums[t];
+    }
+    for (size_t u = begin; u < end; u++) {
+        running += build->rowOffsets[u + 1];
+        build->rowOffsets[u + 1] = running;
+        build->cursor[u + 1] = running;
+    }
+}
+
+// Phase 3: scatter every edge into its row
+// Rows are filled through atomic cursors, so the order within a row depends
+// on thread timing; the set of followees does not.
+static void scatterEdgesTask(int threadId, int numThreads, void* arg) {
+    struct EdgeListBuild* build = (struct EdgeListBuild*)arg;
+    size_t begin, end;
+    chunkRange(build->numEdges, threadId, numThreads, &begin, &end);
+    
+    for (size_t e = begin; e < end; e++) {
+        uint64_t src = edgeEndpoint(build, e, 0);
+        size_t slot = __atomic_fetch_add(&build->cursor[src], 1, __ATOMIC_RELAXED);
+        build->followees[slot] = (int)edgeEndpoint(build, e, 1);
+    }
+}
+
+// Function to build a CSR graph from a binary edge file with numThreads threads
+// The file is mapped, not read: the build makes no per-edge syscalls or
+// allocations, only the CSR arrays themselves.
+struct Graph* loadEdgeFile(const char* path, int numThreads) {
+    struct MappedFile file;
+    if (mapFile(path, &file) != 0) {
+        fprintf(stderr, "Cannot open edge file %s\n", path);
+        return NULL;
+    }
+    
+    const struct EdgeFileHeader* header = (const struct EdgeFileHeader*)file.data;
+    if (file.length < sizeof(*header) || memcmp(header->magic, EDGE_FILE_MAGIC, 8) != 0 ||
+        header->version != EDGE_FILE_VERSION || (header->idBytes != 4 && header->idBytes != 8) ||
+        header->numUsers > MAX_USERS ||
+        (file.length - sizeof(*header)) / (2 * header->idBytes) < header->numEdges) {
+        fprintf(stderr, "%s is not a valid edge file\n", path);
+        unmapFile(&file);
+        return NULL;
+    }
+    
+#ifdef MADV_WILLNEED
+    madvise(file.data, file.length, MADV_WILLNEED);
+#endif
+    
+    struct Graph* graph = createGraph((int)header->numUsers);
+    struct EdgeListBuild build;
+    build.edges = (const unsigned char*)file.data + sizeof(*header);
+    build.idBytes = header->idBytes;
+    build.numEdges = (size_t)header->numEdges;
+    build.numUsers = graph->numUsers;
+    build.rowOffsets = graph->rowOffsets;
+    build.cursor = (size_t*)malloc(((size_t)graph->numUsers + 1) * sizeof(size_t));
+    build.followees = (int*)malloc((build.numEdges ? build.numEdges : 1) * sizeof(int));
+    build.blockSums = (size_t*)calloc(numThreads > 0 ? numThreads : 1, sizeof(size_t));
+    build.invalid = 0;
+    build.cursor[0] = 0;
+    
+    runParallel(numThreads, countDegreesTask, &build);
+    if (__atomic_load_n(&build.invalid, __ATOMIC_RELAXED)) {
+        fprintf(stderr, "%s contains a user id >= %d\n", path, graph->numUsers);
+        free(build.cursor);
+        free(build.followees);
+        free(build.blockSums);
+        freeGraph(graph);
+        unmapFile(&file);
+        return NULL;
+    }
+    runParallel(numThreads, blockSumTask, &build);
+    runParallel(numThreads, blockPrefixTask, &build);
+    runParallel(numThreads, scatterEdgesTask, &build);
+    
+    graph->followees = build.followees;
+    graph->numEdges = build.numEdges;
+    free(build.cursor);
+    free(build.blockSums);
+    unmapFile(&file);
+    return graph;
+}
+
+// Function to write the CSR arrays of a compacted graph as a cached image
+// Returns 0 on success.
+int saveCSRImage(const struct Graph* graph, const char* path, const char* sourcePath) {
+    struct CSRImageHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CSR_IMAGE_MAGIC, 8);
+    header.version = CSR_IMAGE_VERSION;
+    header.numUsers = (uint64_t)graph->numUsers;
+    header.numEdges = (uint64_t)graph->numEdges;
+    
+    struct stat st;
+    if (sourcePath && stat(sourcePath, &st) == 0) {
+        header.sourceBytes = (uint64_t)st.st_size;
+        header.sourceMtime = (int64_t)st.st_mtime;
+    }
+    
+    FILE* fp = fopen(path, "wb");
+    if (!fp) return -1;
+    int ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+    for (int u = 0; ok && u <= graph->numUsers; u++) {
+        uint64_t offset = (uint64_t)graph->rowOffsets[u];
+        ok = fwrite(&offset, sizeof(offset), 1, fp) == 1;
+    }
+    if (ok && graph->numEdges > 0) {
+        ok = fwrite(graph->followees, sizeof(int), graph->numEdges, fp) == graph->numEdges;
+    }
+    ok = (fclose(fp) == 0) && ok;
+    if (!ok) remove(path);
+    return ok ? 0 : -1;
+}
+
+// Function to map a cached CSR image as a graph without rebuilding it
+// The graph's arrays point straight into the mapping, so startup cost is
+// independent of the edge count. Returns NULL if the image is missing,
+// malformed or older than sourcePath (when given). One sequential pass
+// checks that offsets never decrease and every followee is a valid user,
+// so a corrupted image is rejected (and rebuilt) instead of crashing later.
+struct Graph* loadCSRImage(const char* path, const char* sourcePath) {
+    // Offsets are mapped in place, which needs a 64-bit size_t
+    if (sizeof(size_t) != sizeof(uint64_t)) return NULL;
+    
+    struct MappedFile file;
+    if (mapFile(path, &file) != 0) return NULL;
+    
+    const struct CSRImageHeader* header = (const struct CSRImageHeader*)file.data;
+    int valid = file.length >= sizeof(*header) &&
+                memcmp(header->magic, CSR_IMAGE_MAGIC, 8) == 0 &&
+                header->version == CSR_IMAGE_VERSION &&
+                header->numUsers <= MAX_USERS;
+    if (valid) {
+        // numUsers is capped, so the offsets size cannot overflow; numEdges
+        // is compared by division for the same reason
+        uint64_t offsetBytes = (header->numUsers + 1) * sizeof(uint64_t);
+        uint64_t body = (uint64_t)(file.length - sizeof(*header));
+        valid = body >= offsetBytes && (body - offsetBytes) % sizeof(int) == 0 &&
+                (body - offsetBytes) / sizeof(int) == header->numEdges;
+    }
+    
+    struct stat st;
+    if (valid && sourcePath && stat(sourcePath, &st) == 0) {
+        valid = header->sourceBytes == (uint64_t)st.st_size &&
+                header->sourceMtime == (int64_t)st.st_mtime;
+    }
+    
+    const uint64_t* offsets = (const uint64_t*)((const char*)file.data + sizeof(*header));
+    if (valid) {
+        valid = offsets[0] == 0 && offsets[header->numUsers] == header->numEdges;
+    }
+    if (valid) {
+        const int* followees = (const int*)(offsets + header->numUsers + 1);
+        int numUsers = (int)header->numUsers;
+        for (uint64_t u = 0; valid && u < header->numUsers; u++) {
+            valid = offsets[u] <= offsets[u + 1];
+        }
+        for (uint64_t e = 0; valid && e < header->numEdges; e++) {
+            valid = followees[e] >= 0 && followees[e] < numUsers;
+        }
+    }
+    if (!valid) {
+        unmapFile(&file);
+        return NULL;
+    }
+    
+    struct Graph* graph = createGraph((int)header->numUsers);
+    free(graph->rowOffsets);
+    graph->rowOffsets = (size_t*)offsets;
+    graph->followees = (int*)(offsets + header->numUsers + 1);
+    graph->numEdges = (size_t)header->numEdges;
+    graph->image = file;
+    return graph;
+}
+
+// Function to load the social graph, preferring a fresh cached CSR image
+// On a cache miss the graph is built from the edge file and the image is
+// (re)written so the next start can skip the build.
+struct Graph* loadSocialGraph(const char* edgePath, const char* cachePath, int numThreads, int* fromCache) {
+    *fromCache = 0;
+    if (cachePath) {
+        struct Graph* cached = loadCSRImage(cachePath, edgePath);
+        if (cached) {
+            *fromCache = 1;
+            return cached;
         }
-        temp = temp->next;
     }
     
-    // Record finish time
-    finish[user] = ++time_counter;
-    printf("User %d: Finished at time %d\n", user, finish[user]);
+    struct Graph* graph = loadEdgeFile(edgePath, numThreads);
+    if (graph && cachePath && saveCSRImage(graph, cachePath, edgePath) != 0) {
+        fprintf(stderr, "Warning: could not write CSR image %s\n", cachePath);
+    }
+    return graph;
+}
+
+// Function to create a DFS context for a graph with numUsers users
+struct DFSContext* createDFSContext(int numUsers) {
+    struct DFSContext* ctx = (struct DFSContext*)malloc(sizeof(struct DFSContext));
+    ctx->numUsers = numUsers;
+    ctx->discovery = (int*)calloc(numUsers, sizeof(int));
+    ctx->finish = (int*)calloc(numUsers, sizeof(int));
+    ctx->visited = (unsigned char*)calloc(numUsers, sizeof(unsigned char));
+    ctx->timeCounter = 0;
+    ctx->verbose = 0;
+    
+    // Every user is pushed at most once, so numUsers entries always suffice
+    ctx->stackUsers = (int*)malloc(numUsers * sizeof(int));
+    ctx->stackEdges = (size_t*)malloc(numUsers * sizeof(size_t));
+    ctx->stackTop = 0;
+    ctx->edgesScanned = 0;
+    ctx->maxStackDepth = 0;
+    return ctx;
+}
+
+// Function to reset a DFS context before a new traversal
+void resetDFSContext(struct DFSContext* ctx) {
+    memset(ctx->discovery, 0, ctx->numUsers * sizeof(int));
+    memset(ctx->finish, 0, ctx->numUsers * sizeof(int));
+    memset(ctx->visited, 0, ctx->numUsers * sizeof(unsigned char));
+    ctx->timeCounter = 0;
+    ctx->stackTop = 0;
+    ctx->edgesScanned = 0;
+    ctx->maxStackDepth = 0;
+}
+
+// Function to free a DFS context
+void freeDFSContext(struct DFSContext* ctx) {
+    free(ctx->discovery);
+    free(ctx->finish);
+    free(ctx->visited);
+    free(ctx->stackUsers);
+    free(ctx->stackEdges);
+    free(ctx);
+}
+
+// Function to mark a user as discovered and push it on the DFS stack
+static void dfsDiscover(const struct Graph* graph, struct DFSContext* ctx, int user) {
+    ctx->visited[user] = 1;
+    ctx->discovery[user] = ++ctx->timeCounter;
+    
+    if (ctx->verbose) printf("User %d: Discovered at time %d\n", user, ctx->discovery[user]);
+    
+    ctx->stackUsers[ctx->stackTop] = user;
+    ctx->stackEdges[ctx->stackTop] = graph->rowOffsets[user];
+    ctx->stackTop++;
+    if (ctx->stackTop > ctx->maxStackDepth) ctx->maxStackDepth = ctx->stackTop;
 }
 
-// Function to initialize arrays
-void initialize(int numUsers) {
-    for (int i = 0; i < numUsers; i++) {
-        visited[i] = 0;
-        discovery[i] = 0;
-        finish[i] = 0;
+// DFS function with timestamps
+// Iterative version of the recursive DFS: the explicit stack replaces the
+// call stack, so long follow chains cannot overflow it. Calling DFS again on
+// the same context from another unvisited user continues the timestamps,
+// which builds a DFS forest. Steps are printed only when ctx->verbose is set.
+void DFS(const struct Graph* graph, struct DFSContext* ctx, int user) {
+    if (ctx->visited[user]) return;
+    
+    // Mark current user as visited and record discovery time
+    dfsDiscover(graph, ctx, user);
+    
+    while (ctx->stackTop > 0) {
+        int top = ctx->stackTop - 1;
+        int current = ctx->stackUsers[top];
+        size_t e = ctx->stackEdges[top];
+        
+        if (e < graph->rowOffsets[current + 1]) {
+            // Traverse the next adjacent user (a user that current user follows)
+            int adjUser = graph->followees[e];
+            ctx->stackEdges[top] = e + 1;
+            ctx->edgesScanned++;
+            
+            if (!ctx->visited[adjUser]) {
+                if (ctx->verbose) printf("  User %d follows User %d (exploring...)\n", current, adjUser);
+                dfsDiscover(graph, ctx, adjUser);
+            } else if (ctx->verbose) {
+                printf("  User %d follows User %d (already visited)\n", current, adjUser);
+            }
+        } else {
+            // All followees explored: record finish time
+            ctx->finish[current] = ++ctx->timeCounter;
+            if (ctx->verbose) printf("User %d: Finished at time %d\n", current, ctx->finish[current]);
+            ctx->stackTop--;
+        }
     }
-    time_counter = 0;
 }
 
 // Function to print the adjacency list
 void printGraph(struct Graph* graph) {
     printf("=== ADJACENCY LIST REPRESENTATION ===\n");
     for (int i = 0; i < graph->numUsers; ++i) {
-        struct AdjListNode* temp = graph->array[i].head;
         printf("User %d follows: ", i);
-        if (temp == NULL) {
+        if (graph->rowOffsets[i] == graph->rowOffsets[i + 1]) {
             printf("(no one)");
         } else {
-            while (temp) {
-                printf("%d ", temp->dest);
-                temp = temp->next;
+            for (size_t e = graph->rowOffsets[i]; e < graph->rowOffsets[i + 1]; e++) {
+                printf("%d ", graph->followees[e]);
             }
         }
         printf("\n");
@@ -112,16 +655,16 @@ void printGraph(struct Graph* graph) {
 }
 
 // Function to display timestamps in tabular format
-void displayTimestamps(int numUsers) {
+void displayTimestamps(const struct DFSContext* ctx) {
     printf("=== DFS TIMESTAMPS RESULTS ===\n");
     printf("User\tDiscovery Time\tFinish Time\tDuration\tStatus\n");
     printf("----\t--------------\t-----------\t--------\t------\n");
     
-    for (int i = 0; i < numUsers; i++) {
-        if (visited[i]) {
-            int duration = finish[i] - discovery[i];
+    for (int i = 0; i < ctx->numUsers; i++) {
+        if (ctx->visited[i]) {
+            int duration = ctx->finish[i] - ctx->discovery[i];
             printf("%d\t%d\t\t%d\t\t%d\t\tVisited\n", 
-                   i, discovery[i], finish[i], duration);
+                   i, ctx->discovery[i], ctx->finish[i], duration);
         } else {
             printf("%d\t-\t\t-\t\t-\t\tNot Reachable\n", i);
         }
@@ -129,48 +672,59 @@ void displayTimestamps(int numUsers) {
     printf("\n");
 }
 
-// Function to analyze influential users based on timestamps
-void analyzeInfluentialUsers(int numUsers) {
-    printf("=== INFLUENTIAL USER ANALYSIS ===\n");
-    
-    // Find users with highest discovery times (most deeply nested)
-    int maxDiscovery = 0;
-    int deepestUser = -1;
+// Results of the timestamp-based analysis, computed without printing
+struct TimestampAnalysis {
+    int reachableUsers;      // Users visited by the traversal
+    int deepestUser;         // Highest discovery time (most deeply nested)
+    int maxDiscovery;
+    int shortestUser;        // Smallest finish - discovery (likely a leaf)
+    int minDuration;
+    int leafUsers;           // Visited users with duration 1 (follow no one unvisited)
+};
+
+// Function to compute the timestamp analysis from a finished traversal
+struct TimestampAnalysis computeTimestampAnalysis(const struct DFSContext* ctx) {
+    struct TimestampAnalysis result = {0, -1, 0, -1, INT_MAX, 0};
     
-    for (int i = 0; i < numUsers; i++) {
-        if (visited[i] && discovery[i] > maxDiscovery) {
-            maxDiscovery = discovery[i];
-            deepestUser = i;
+    for (int i = 0; i < ctx->numUsers; i++) {
+        if (!ctx->visited[i]) continue;
+        int duration = ctx->finish[i] - ctx->discovery[i];
+        
+        result.reachableUsers++;
+        if (ctx->discovery[i] > result.maxDiscovery) {
+            result.maxDiscovery = ctx->discovery[i];
+            result.deepestUser = i;
         }
-    }
-    
-    // Find users with smallest duration (likely leaf nodes - influential)
-    int minDuration = 999;
-    int mostInfluential = -1;
-    
-    for (int i = 0; i < numUsers; i++) {
-        if (visited[i]) {
-            int duration = finish[i] - discovery[i];
-            if (duration < minDuration) {
-                minDuration = duration;
-                mostInfluential = i;
-            }
+        if (duration < result.minDuration) {
+            result.minDuration = duration;
+            result.shortestUser = i;
         }
+        if (duration == 1) result.leafUsers++;
     }
+    return result;
+}
+
+// Function to analyze influential users based on timestamps
+void analyzeInfluentialUsers(const struct DFSContext* ctx) {
+    printf("=== INFLUENTIAL USER ANALYSIS ===\n");
+    
+    // Find the most deeply nested user and the user with the smallest
+    // duration (likely leaf nodes - influential)
+    struct TimestampAnalysis result = computeTimestampAnalysis(ctx);
     
     printf("Analysis Results:\n");
     printf("1. Most deeply nested user: User %d (discovered at time %d)\n", 
-           deepestUser, maxDiscovery);
+           result.deepestUser, result.maxDiscovery);
     printf("   → This user is deep in the connection chain, likely influential\n");
     
     printf("2. User with shortest exploration duration: User %d (duration: %d)\n", 
-           mostInfluential, minDuration);
+           result.shortestUser, result.minDuration);
     printf("   → This suggests a leaf node - potentially most influential\n");
     
     // List all leaf nodes (users who don't follow anyone)
     printf("3. Leaf nodes (don't follow anyone - highly influential):\n");
-    for (int i = 0; i < numUsers; i++) {
-        if (visited[i] && (finish[i] - discovery[i]) == 1) {
+    for (int i = 0; i < ctx->numUsers; i++) {
+        if (ctx->visited[i] && (ctx->finish[i] - ctx->discovery[i]) == 1) {
             printf("   → User %d (leaf node)\n", i);
         }
     }
@@ -178,12 +732,12 @@ void analyzeInfluentialUsers(int numUsers) {
 }
 
 // Function to analyze reachability
-void analyzeReachability(int numUsers) {
+void analyzeReachability(const struct DFSContext* ctx) {
     printf("=== REACHABILITY ANALYSIS ===\n");
     
     printf("Users reachable from User 0: ");
-    for (int i = 0; i < numUsers; i++) {
-        if (visited[i]) {
+    for (int i = 0; i < ctx->numUsers; i++) {
+        if (ctx->visited[i]) {
             printf("%d ", i);
         }
     }
@@ -191,8 +745,8 @@ void analyzeReachability(int numUsers) {
     
     printf("Users NOT reachable from User 0: ");
     int hasUnreachable = 0;
-    for (int i = 0; i < numUsers; i++) {
-        if (!visited[i]) {
+    for (int i = 0; i < ctx->numUsers; i++) {
+        if (!ctx->visited[i]) {
             printf("%d ", i);
             hasUnreachable = 1;
         }
@@ -203,53 +757,2669 @@ void analyzeReachability(int numUsers) {
     printf("\n\n");
 }
 
-int main() {
-    printf("=== SOCIAL MEDIA USER CONNECTION ANALYSIS ===\n");
-    printf("Using DFS with Timestamps to Identify Influential Users\n\n");
-    
-    // Create graph with 5 users (0, 1, 2, 3, 4)
-    struct Graph* graph = createGraph(5);
+// ===================== METRICS REPORT =====================
+//
+// Machine-readable summary of one load + traverse + analyze run, for
+// profiling without terminal output. JSON is one object; CSV is one
+// "kind,key,value,finish" row per metric or per visited user.
+
+enum ReportFormat {
+    REPORT_JSON,
+    REPORT_CSV
+};
+
+// Per-phase wall-clock timings of one run
+struct RunMetrics {
+    double loadSeconds;
+    double traverseSeconds;
+    double analyzeSeconds;
+};
+
+// Function to write the run report; returns 0 on success
+int writeRunReport(const char* path, enum ReportFormat format, const struct Graph* graph, int source,
+                   const struct DFSContext* ctx, const struct TimestampAnalysis* analysis,
+                   const struct RunMetrics* metrics) {
+    FILE* fp = fopen(path, "w");
+    if (!fp) return -1;
     
-    // Add edges based on the given adjacency list
-    // 0 → 1, 2
-    addEdge(graph, 0, 1);
-    addEdge(graph, 0, 2);
+    if (format == REPORT_JSON) {
+        fprintf(fp, "{\n");
+        fprintf(fp, "  \"graph\": {\"users\": %d, \"edges\": %zu},\n", graph->numUsers, graph->numEdges);
+        fprintf(fp, "  \"source\": %d,\n", source);
+        fprintf(fp, "  \"phases\": {\"load_s\": %.6f, \"traverse_s\": %.6f, \"analyze_s\": %.6f},\n",
+                metrics->loadSeconds, metrics->traverseSeconds, metrics->analyzeSeconds);
+        fprintf(fp, "  \"counters\": {\"edges_scanned\": %zu, \"max_stack_depth\": %d},\n",
+                ctx->edgesScanned, ctx->maxStackDepth);
+        fprintf(fp, "  \"analysis\": {\"reachable_users\": %d, \"deepest_user\": %d, \"max_discovery\": %d, "
+                    "\"shortest_user\": %d, \"min_duration\": %d, \"leaf_users\": %d},\n",
+                analysis->reachableUsers, analysis->deepestUser, analysis->maxDiscovery,
+                analysis->shortestUser, analysis->reachableUsers ? analysis->minDuration : 0,
+                analysis->leafUsers);
+        fprintf(fp, "  \"timestamps\": [");
+        int first = 1;
+        for (int u = 0; u < ctx->numUsers; u++) {
+            if (!ctx->visited[u]) continue;
+            fprintf(fp, "%s\n    {\"user\": %d, \"discovery\": %d, \"finish\": %d}",
+                    first ? "" : ",", u, ctx->discovery[u], ctx->finish[u]);
+            first = 0;
+        }
+        fprintf(fp, "%s]\n}\n", first ? "" : "\n  ");
+    } else {
+        fprintf(fp, "kind,key,value,finish\n");
+        fprintf(fp, "graph,users,%d,\n", graph->numUsers);
+        fprintf(fp, "graph,edges,%zu,\n", graph->numEdges);
+        fprintf(fp, "graph,source,%d,\n", source);
+        fprintf(fp, "phase,load_s,%.6f,\n", metrics->loadSeconds);
+        fprintf(fp, "phase,traverse_s,%.6f,\n", metrics->traverseSeconds);
+        fprintf(fp, "phase,analyze_s,%.6f,\n", metrics->analyzeSeconds);
+        fprintf(fp, "counter,edges_scanned,%zu,\n", ctx->edgesScanned);
+        fprintf(fp, "counter,max_stack_depth,%d,\n", ctx->maxStackDepth);
+        fprintf(fp, "analysis,reachable_users,%d,\n", analysis->reachableUsers);
+        fprintf(fp, "analysis,deepest_user,%d,\n", analysis->deepestUser);
+        fprintf(fp, "analysis,max_discovery,%d,\n", analysis->maxDiscovery);
+        fprintf(fp, "analysis,shortest_user,%d,\n", analysis->shortestUser);
+        fprintf(fp, "analysis,min_duration,%d,\n", analysis->reachableUsers ? analysis->minDuration : 0);
+        fprintf(fp, "analysis,leaf_users,%d,\n", analysis->leafUsers);
+        for (int u = 0; u < ctx->numUsers; u++) {
+            if (ctx->visited[u]) {
+                fprintf(fp, "timestamp,%d,%d,%d\n", u, ctx->discovery[u], ctx->finish[u]);
+            }
+        }
+    }
     
-    // 1 → 3
-    addEdge(graph, 1, 3);
+    return fclose(fp) == 0 ? 0 : -1;
+}
+
+// ===================== MULTI-SOURCE REACHABILITY =====================
+//
+// Answers "can source s reach user u" for a whole batch of sources in one
+// sweep (MS-BFS): every user carries one bit per source, and a BFS level
+// moves all sources' frontiers across an edge with a few word-wide AND/OR
+// operations instead of one traversal per source.
+
+#define REACH_BITS_PER_WORD 64
+
+// Reachability of a batch of sources, stored as a bitset matrix
+// Row u holds wordsPerUser words; bit s of row u is set if sources[s] reaches u.
+struct ReachabilityMatrix {
+    int numUsers;
+    int numSources;
+    int wordsPerUser;
+    int* sources;
+    uint64_t* bits;
+};
+
+// Function to check whether the source at sourceIndex can reach user
+int canReach(const struct ReachabilityMatrix* matrix, int sourceIndex, int user) {
+    const uint64_t* row = matrix->bits + (size_t)user * matrix->wordsPerUser;
+    return (int)((row[sourceIndex / REACH_BITS_PER_WORD] >> (sourceIndex % REACH_BITS_PER_WORD)) & 1);
+}
+
+// Function to count the users reachable from the source at sourceIndex
+int countReachable(const struct ReachabilityMatrix* matrix, int sourceIndex) {
+    int count = 0;
+    for (int u = 0; u < matrix->numUsers; u++) {
+        count += canReach(matrix, sourceIndex, u);
+    }
+    return count;
+}
+
+void freeReachabilityMatrix(struct ReachabilityMatrix* matrix) {
+    free(matrix->sources);
+    free(matrix->bits);
+    free(matrix);
+}
+
+// Function to compute reachability from a batch of sources in one BFS sweep
+// Batches of 64-512 sources keep a row within one cache line or a few SIMD
+// registers; the per-word loops below are plain enough for the compiler to
+// vectorize. Memory is three n x wordsPerUser bitsets (seen, visit, next).
+struct ReachabilityMatrix* computeMultiSourceReachability(const struct Graph* graph,
+                                                          const int* sources, int numSources) {
+    int n = graph->numUsers;
+    int words = (numSources + REACH_BITS_PER_WORD - 1) / REACH_BITS_PER_WORD;
+    size_t cells = (size_t)n * words;
     
-    // 2 → 4
-    addEdge(graph, 2, 4);
+    struct ReachabilityMatrix* matrix = (struct ReachabilityMatrix*)malloc(sizeof(struct ReachabilityMatrix));
+    matrix->numUsers = n;
+    matrix->numSources = numSources;
+    matrix->wordsPerUser = words;
+    matrix->sources = (int*)malloc((numSources > 0 ? (size_t)numSources : 1) * sizeof(int));
+    memcpy(matrix->sources, sources, numSources * sizeof(int));
+    matrix->bits = (uint64_t*)calloc(cells ? cells : 1, sizeof(uint64_t));
     
-    // 3 → (no one)
-    // 4 → (no one)
+    uint64_t* seen = matrix->bits;   // Sources that have reached each user
+    uint64_t* visit = (uint64_t*)calloc(cells ? cells : 1, sizeof(uint64_t));   // Sources arriving this level
+    uint64_t* next = (uint64_t*)calloc(cells ? cells : 1, sizeof(uint64_t));    // Sources arriving next level
     
-    // Print the graph structure
-    printGraph(graph);
+    // Users whose visit row is non-empty, and a flag to list each only once
+    int* frontier = (int*)malloc((n > 0 ? (size_t)n : 1) * sizeof(int));
+    int* nextFrontier = (int*)malloc((n > 0 ? (size_t)n : 1) * sizeof(int));
+    unsigned char* inNext = (unsigned char*)calloc(n ? n : 1, sizeof(unsigned char));
+    int frontierSize = 0;
     
-    // Initialize arrays
-    initialize(5);
+    for (int s = 0; s < numSources; s++) {
+        int user = sources[s];
+        uint64_t bit = (uint64_t)1 << (s % REACH_BITS_PER_WORD);
+        seen[(size_t)user * words + s / REACH_BITS_PER_WORD] |= bit;
+        visit[(size_t)user * words + s / REACH_BITS_PER_WORD] |= bit;
+        if (!inNext[user]) {
+            inNext[user] = 1;
+            frontier[frontierSize++] = user;
+        }
+    }
+    for (int i = 0; i < frontierSize; i++) {
+        inNext[frontier[i]] = 0;
+    }
     
-    // Perform DFS starting from user 0
-    printf("=== DFS TRAVERSAL WITH TIMESTAMPS ===\n");
-    printf("Starting DFS from User 0:\n\n");
+    while (frontierSize > 0) {
+        int nextSize = 0;
+        
+        // Push every source bit in visit[v] that is new to each followee
+        for (int i = 0; i < frontierSize; i++) {
+            int v = frontier[i];
+            const uint64_t* visitRow = visit + (size_t)v * words;
+            
+            for (size_t e = graph->rowOffsets[v]; e < graph->rowOffsets[v + 1]; e++) {
+                int w = graph->followees[e];
+                const uint64_t* seenRow = seen + (size_t)w * words;
+                uint64_t* nextRow = next + (size_t)w * words;
+                uint64_t arrived = 0;
+                
+                for (int k = 0; k < words; k++) {
+                    uint64_t fresh = visitRow[k] & ~seenRow[k];
+                    nextRow[k] |= fresh;
+                    arrived |= fresh;
+                }
+                if (arrived && !inNext[w]) {
+                    inNext[w] = 1;
+                    nextFrontier[nextSize++] = w;
+                }
+            }
+        }
+        
+        // Retire this level, then promote next into visit and seen
+        for (int i = 0; i < frontierSize; i++) {
+            memset(visit + (size_t)frontier[i] * words, 0, words * sizeof(uint64_t));
+        }
+        for (int i = 0; i < nextSize; i++) {
+            int w = nextFrontier[i];
+            uint64_t* seenRow = seen + (size_t)w * words;
+            uint64_t* visitRow = visit + (size_t)w * words;
+            uint64_t* nextRow = next + (size_t)w * words;
+            for (int k = 0; k < words; k++) {
+                seenRow[k] |= nextRow[k];
+                visitRow[k] = nextRow[k];
+                nextRow[k] = 0;
+            }
+            inNext[w] = 0;
+        }
+        
+        int* swap = frontier;
+        frontier = nextFrontier;
+        nextFrontier = swap;
+        frontierSize = nextSize;
+    }
     
-    DFS(graph, 0);
+    free(visit);
+    free(next);
+    free(frontier);
+    free(nextFrontier);
+    free(inNext);
+    return matrix;
+}
+
+// Function to print the reachability matrix (sources as rows)
+void displayReachabilityMatrix(const struct ReachabilityMatrix* matrix) {
+    printf("=== MULTI-SOURCE REACHABILITY MATRIX ===\n");
+    printf("Source\\User");
+    for (int u = 0; u < matrix->numUsers; u++) {
+        printf("\t%d", u);
+    }
+    printf("\n");
     
+    for (int s = 0; s < matrix->numSources; s++) {
+        printf("%d\t", matrix->sources[s]);
+        for (int u = 0; u < matrix->numUsers; u++) {
+            printf("\t%s", canReach(matrix, s, u) ? "yes" : "-");
+        }
+        printf("\n");
+    }
     printf("\n");
+}
+
+// ===================== STRONGLY CONNECTED COMPONENTS =====================
+//
+// Three engines fill the same SCCResult:
+//   - Tarjan:    one iterative DFS with low-links
+//   - Kosaraju:  reuses the finish times of a DFSContext, then sweeps the
+//                transposed graph in decreasing finish order
+//   - Parallel:  forward-backward (FW-BW) decomposition with trimming; each
+//                color class is an independent task, so worker threads pick
+//                tasks from a shared queue
+// buildCondensation() then collapses every component to one vertex of a DAG.
+
+#define SCC_SEQUENTIAL_CUTOFF 1024   // FW-BW tasks at most this size run Tarjan
+
+struct SCCResult {
+    int numUsers;
+    int numComponents;
+    int* componentOf;     // Component id of each user
+    int* componentSize;   // Number of users in each component
+};
+
+// Function to build the transposed graph (who follows each user)
+struct Graph* transposeGraph(const struct Graph* graph) {
+    int n = graph->numUsers;
+    struct Graph* reverse = createGraph(n);
+    size_t* offsets = reverse->rowOffsets;
     
-    // Display results in tabular format
-    displayTimestamps(5);
+    for (size_t e = 0; e < graph->numEdges; e++) {
+        offsets[graph->followees[e] + 1]++;
+    }
+    for (int u = 0; u < n; u++) {
+        offsets[u + 1] += offsets[u];
+    }
     
-    // Analyze influential users
-    analyzeInfluentialUsers(5);
+    size_t* cursor = (size_t*)malloc(((size_t)n + 1) * sizeof(size_t));
+    memcpy(cursor, offsets, ((size_t)n + 1) * sizeof(size_t));
+    reverse->followees = (int*)malloc((graph->numEdges ? graph->numEdges : 1) * sizeof(int));
+    for (int u = 0; u < n; u++) {
+        for (size_t e = graph->rowOffsets[u]; e < graph->rowOffsets[u + 1]; e++) {
+            reverse->followees[cursor[graph->followees[e]]++] = u;
+        }
+    }
+    free(cursor);
     
-    // Analyze reachability
-    analyzeReachability(5);
+    reverse->numEdges = graph->numEdges;
+    return reverse;
+}
+
+static struct SCCResult* createSCCResult(int numUsers) {
+    struct SCCResult* scc = (struct SCCResult*)malloc(sizeof(struct SCCResult));
+    scc->numUsers = numUsers;
+    scc->numComponents = 0;
+    scc->componentOf = (int*)malloc((numUsers > 0 ? (size_t)numUsers : 1) * sizeof(int));
+    scc->componentSize = NULL;
+    return scc;
+}
+
+// Function to fill componentSize once every user has a component id
+static void finishSCCResult(struct SCCResult* scc) {
+    scc->componentSize = (int*)calloc(scc->numComponents ? scc->numComponents : 1, sizeof(int));
+    for (int u = 0; u < scc->numUsers; u++) {
+        scc->componentSize[scc->componentOf[u]]++;
+    }
+}
+
+void freeSCCResult(struct SCCResult* scc) {
+    free(scc->componentOf);
+    free(scc->componentSize);
+    free(scc);
+}
+
+// Scratch arrays for iterative Tarjan, indexed by user
+// The SCC and call stacks are sized per call, so they are passed to
+// tarjanFromRoots separately.
+struct TarjanState {
+    int* index;           // DFS preorder number + 1 (0 = unvisited)
+    int* lowLink;
+    unsigned char* onStack;
+};
+
+// Function to run Tarjan from each of roots, restricted to users whose color
+// equals color (every user when colors is NULL)
+// Component ids come from *nextComponent, updated atomically so FW-BW tasks
+// can share one counter. sccStack holds users of components still being
+// built; callUsers/callEdges form the explicit call stack (user, next CSR
+// edge). Each stack needs room for every user reachable in the restricted
+// subgraph.
+static void tarjanFromRoots(const struct Graph* graph, const int* roots, int numRoots,
+                            const int* colors, int color, struct TarjanState* state,
+                            int* sccStack, int* callUsers, size_t* callEdges,
+                            int* componentOf, int* nextComponent) {
+    int counter = 0;
+    int sccTop = 0;
     
-    // Free allocated memory
-    free(graph->array);
-    free(graph);
+    for (int r = 0; r < numRoots; r++) {
+        int root = roots[r];
+        if (state->index[root]) continue;
+        
+        int callTop = 0;
+        state->index[root] = state->lowLink[root] = ++counter;
+        state->onStack[root] = 1;
+        sccStack[sccTop++] = root;
+        callUsers[callTop] = root;
+        callEdges[callTop++] = graph->rowOffsets[root];
+        
+        while (callTop > 0) {
+            int u = callUsers[callTop - 1];
+            size_t e = callEdges[callTop - 1];
+            
+            if (e < graph->rowOffsets[u + 1]) {
+                int w = graph->followees[e];
+                callEdges[callTop - 1] = e + 1;
+                if (colors && __atomic_load_n(&colors[w], __ATOMIC_RELAXED) != color) continue;
+                
+                if (!state->index[w]) {
+                    state->index[w] = state->lowLink[w] = ++counter;
+                    state->onStack[w] = 1;
+                    sccStack[sccTop++] = w;
+                    callUsers[callTop] = w;
+                    callEdges[callTop++] = graph->rowOffsets[w];
+                } else if (state->onStack[w] && state->index[w] < state->lowLink[u]) {
+                    state->lowLink[u] = state->index[w];
+                }
+                continue;
+            }
+            
+            // u is finished: it roots a component if no back edge escaped it
+            if (state->lowLink[u] == state->index[u]) {
+                int id = __atomic_fetch_add(nextComponent, 1, __ATOMIC_RELAXED);
+                int member;
+                do {
+                    member = sccStack[--sccTop];
+                    state->onStack[member] = 0;
+                    componentOf[member] = id;
+                } while (member != u);
+            }
+            callTop--;
+            if (callTop > 0) {
+                int parent = callUsers[callTop - 1];
+                if (state->lowLink[u] < state->lowLink[parent]) {
+                    state->lowLink[parent] = state->lowLink[u];
+                }
+            }
+        }
+    }
+}
+
+static void initTarjanState(struct TarjanState* state, int n) {
+    state->index = (int*)calloc(n ? n : 1, sizeof(int));
+    state->lowLink = (int*)malloc((n > 0 ? (size_t)n : 1) * sizeof(int));
+    state->onStack = (unsigned char*)calloc(n ? n : 1, sizeof(unsigned char));
+}
+
+static void freeTarjanState(struct TarjanState* state) {
+    free(state->index);
+    free(state->lowLink);
+    free(state->onStack);
+}
+
+// Function to compute SCCs with Tarjan's algorithm
+// Ids come out in reverse topological order of the condensation (sinks first).
+struct SCCResult* computeSCCTarjan(const struct Graph* graph) {
+    int n = graph->numUsers;
+    struct SCCResult* scc = createSCCResult(n);
+    struct TarjanState state;
+    initTarjanState(&state, n);
+    
+    int* roots = (int*)malloc((n > 0 ? (size_t)n : 1) * sizeof(int));
+    int* sccStack = (int*)malloc((n > 0 ? (size_t)n : 1) * sizeof(int));
+    int* callUsers = (int*)malloc((n > 0 ? (size_t)n : 1) * sizeof(int));
+    size_t* callEdges = (size_t*)malloc((n > 0 ? (size_t)n : 1) * sizeof(size_t));
+    for (int u = 0; u < n; u++) {
+        roots[u] = u;
+    }
+    
+    tarjanFromRoots(graph, roots, n, NULL, 0, &state, sccStack, callUsers, callEdges,
+                    scc->componentOf, &scc->numComponents);
+    
+    free(roots);
+    free(sccStack);
+    free(callUsers);
+    free(callEdges);
+    freeTarjanState(&state);
+    finishSCCResult(scc);
+    return scc;
+}
+
+// Function to compute SCCs with Kosaraju's algorithm, reusing DFS timestamps
+// ctx may hold a partial traversal (e.g. DFS from user 0 only); the DFS
+// forest is completed from the remaining users first. Ids come out in
+// topological order of the condensation (sources first).
+struct SCCResult* computeSCCKosaraju(const struct Graph* graph, struct DFSContext* ctx) {
+    int n = graph->numUsers;
+    for (int u = 0; u < n; u++) {
+        if (!ctx->visited[u]) DFS(graph, ctx, u);
+    }
+    
+    // Finish times are distinct values in [1, 2n]: bucket users by them
+    int* byFinish = (int*)malloc((2 * (size_t)n + 1) * sizeof(int));
+    for (size_t t = 0; t <= 2 * (size_t)n; t++) {
+        byFinish[t] = -1;
+    }
+    for (int u = 0; u < n; u++) {
+        byFinish[ctx->finish[u]] = u;
+    }
+    
+    struct Graph* reverse = transposeGraph(graph);
+    struct SCCResult* scc = createSCCResult(n);
+    for (int u = 0; u < n; u++) {
+        scc->componentOf[u] = -1;
+    }
+    
+    // Each unlabeled user in decreasing finish order collects its component
+    // from the transposed graph
+    int* stack = (int*)malloc((n > 0 ? (size_t)n : 1) * sizeof(int));
+    for (size_t t = 2 * (size_t)n; t >= 1; t--) {
+        int root = byFinish[t];
+        if (root < 0 || scc->componentOf[root] >= 0) continue;
+        
+        int id = scc->numComponents++;
+        int top = 0;
+        scc->componentOf[root] = id;
+        stack[top++] = root;
+        while (top > 0) {
+            int u = stack[--top];
+            for (size_t e = reverse->rowOffsets[u]; e < reverse->rowOffsets[u + 1]; e++) {
+                int w = reverse->followees[e];
+                if (scc->componentOf[w] < 0) {
+                    scc->componentOf[w] = id;
+                    stack[top++] = w;
+                }
+            }
+        }
+    }
+    
+    free(stack);
+    free(byFinish);
+    freeGraph(reverse);
+    finishSCCResult(scc);
+    return scc;
+}
+
+// One FW-BW task: the users currently carrying one color
+struct SCCTask {
+    int* users;
+    int count;
+    int color;
+};
+
+// Shared state of the parallel FW-BW decomposition
+struct ParallelSCC {
+    const struct Graph* graph;
+    const struct Graph* reverse;
+    int* colors;              // Task color of each user, -1 once its component is known
+    int* componentOf;
+    unsigned char* forward;   // Reached by the current task's forward search
+    unsigned char* backward;  // Reached by the current task's backward search
+    struct TarjanState tarjan;
+    int nextComponent;
+    int nextColor;
+    
+    // Work queue of pending tasks
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    struct SCCTask* tasks;
+    int numTasks;
+    int capacity;
+    int busyWorkers;          // Workers currently running a task
+};
+
+static void pushSCCTask(struct ParallelSCC* par, int* users, int count) {
+    int color = __atomic_fetch_add(&par->nextColor, 1, __ATOMIC_RELAXED);
+    for (int i = 0; i < count; i++) {
+        __atomic_store_n(&par->colors[users[i]], color, __ATOMIC_RELAXED);
+    }
+    
+    pthread_mutex_lock(&par->lock);
+    if (par->numTasks == par->capacity) {
+        par->capacity *= 2;
+        par->tasks = (struct SCCTask*)realloc(par->tasks, par->capacity * sizeof(struct SCCTask));
+    }
+    par->tasks[par->numTasks].users = users;
+    par->tasks[par->numTasks].count = count;
+    par->tasks[par->numTasks].color = color;
+    par->numTasks++;
+    pthread_cond_signal(&par->changed);
+    pthread_mutex_unlock(&par->lock);
+}
+
+// Function to mark everything reachable from pivot inside the task's color
+static void colorRestrictedSearch(const struct Graph* graph, const int* colors, int color,
+                                  int pivot, unsigned char* mark, int* queue) {
+    int head = 0, tail = 0;
+    mark[pivot] = 1;
+    queue[tail++] = pivot;
+    while (head < tail) {
+        int u = queue[head++];
+        for (size_t e = graph->rowOffsets[u]; e < graph->rowOffsets[u + 1]; e++) {
+            int w = graph->followees[e];
+            if (!mark[w] && __atomic_load_n(&colors[w], __ATOMIC_RELAXED) == color) {
+                mark[w] = 1;
+                queue[tail++] = w;
+            }
+        }
+    }
+}
+
+// Function to check whether u has a neighbor (other than itself) in its color
+static int hasNeighborInColor(const struct Graph* graph, const int* colors, int color, int u) {
+    for (size_t e = graph->rowOffsets[u]; e < graph->rowOffsets[u + 1]; e++) {
+        int w = graph->followees[e];
+        if (w != u && __atomic_load_n(&colors[w], __ATOMIC_RELAXED) == color) return 1;
+    }
+    return 0;
+}
+
+// Function to split one task: trim, then forward-backward around a pivot
+static void processSCCTask(struct ParallelSCC* par, struct SCCTask task) {
+    const struct Graph* graph = par->graph;
+    int* users = task.users;
+    int count = task.count;
+    
+    // Small tasks: Tarjan restricted to this color finishes them outright
+    if (count <= SCC_SEQUENTIAL_CUTOFF) {
+        int* sccStack = (int*)malloc(count * sizeof(int));
+        int* callUsers = (int*)malloc(count * sizeof(int));
+        size_t* callEdges = (size_t*)malloc(count * sizeof(size_t));
+        tarjanFromRoots(graph, users, count, par->colors, task.color, &par->tarjan,
+                        sccStack, callUsers, callEdges, par->componentOf, &par->nextComponent);
+        for (int i = 0; i < count; i++) {
+            __atomic_store_n(&par->colors[users[i]], -1, __ATOMIC_RELAXED);
+        }
+        free(sccStack);
+        free(callUsers);
+        free(callEdges);
+        free(users);
+        return;
+    }
+    
+    // Trim: a user with no in- or out-neighbor left in its color is a
+    // singleton component
+    int remaining = 0;
+    for (int i = 0; i < count; i++) {
+        int u = users[i];
+        if (!hasNeighborInColor(graph, par->colors, task.color, u) ||
+            !hasNeighborInColor(par->reverse, par->colors, task.color, u)) {
+            par->componentOf[u] = __atomic_fetch_add(&par->nextComponent, 1, __ATOMIC_RELAXED);
+            __atomic_store_n(&par->colors[u], -1, __ATOMIC_RELAXED);
+        } else {
+            users[remaining++] = u;
+        }
+    }
+    if (remaining == 0) {
+        free(users);
+        return;
+    }
+    
+    // Forward and backward closures of the pivot; their intersection is its SCC
+    int pivot = users[0];
+    int* queue = (int*)malloc(remaining * sizeof(int));
+    colorRestrictedSearch(graph, par->colors, task.color, pivot, par->forward, queue);
+    colorRestrictedSearch(par->reverse, par->colors, task.color, pivot, par->backward, queue);
+    free(queue);
+    
+    // Split into forward-only, backward-only and unreached sets; each can
+    // only contain whole components, so each becomes an independent task
+    int* groups[3];
+    int sizes[3] = {0, 0, 0};
+    for (int g = 0; g < 3; g++) {
+        groups[g] = (int*)malloc(remaining * sizeof(int));
+    }
+    int pivotComponent = __atomic_fetch_add(&par->nextComponent, 1, __ATOMIC_RELAXED);
+    for (int i = 0; i < remaining; i++) {
+        int u = users[i];
+        if (par->forward[u] && par->backward[u]) {
+            par->componentOf[u] = pivotComponent;
+            __atomic_store_n(&par->colors[u], -1, __ATOMIC_RELAXED);
+        } else if (par->forward[u]) {
+            groups[0][sizes[0]++] = u;
+        } else if (par->backward[u]) {
+            groups[1][sizes[1]++] = u;
+        } else {
+            groups[2][sizes[2]++] = u;
+        }
+        par->forward[u] = 0;
+        par->backward[u] = 0;
+    }
+    free(users);
+    
+    for (int g = 0; g < 3; g++) {
+        if (sizes[g] > 0) {
+            pushSCCTask(par, groups[g], sizes[g]);
+        } else {
+            free(groups[g]);
+        }
+    }
+}
+
+static void parallelSCCWorker(int threadId, int numThreads, void* arg) {
+    (void)threadId;
+    (void)numThreads;
+    struct ParallelSCC* par = (struct ParallelSCC*)arg;
+    
+    pthread_mutex_lock(&par->lock);
+    for (;;) {
+        // Done once the queue is empty and no running task can add more
+        while (par->numTasks == 0 && par->busyWorkers > 0) {
+            pthread_cond_wait(&par->changed, &par->lock);
+        }
+        if (par->numTasks == 0) break;
+        
+        struct SCCTask task = par->tasks[--par->numTasks];
+        par->busyWorkers++;
+        pthread_mutex_unlock(&par->lock);
+        
+        processSCCTask(par, task);
+        
+        pthread_mutex_lock(&par->lock);
+        par->busyWorkers--;
+        pthread_cond_broadcast(&par->changed);
+    }
+    pthread_mutex_unlock(&par->lock);
+}
+
+// Function to compute SCCs with parallel forward-backward decomposition
+// reverse is the transposed graph (built here when NULL). Component ids
+// follow no particular order.
+struct SCCResult* computeSCCParallel(const struct Graph* graph, const struct Graph* reverse, int numThreads) {
+    int n = graph->numUsers;
+    struct Graph* ownedReverse = NULL;
+    if (!reverse) reverse = ownedReverse = transposeGraph(graph);
+    
+    struct SCCResult* scc = createSCCResult(n);
+    struct ParallelSCC par;
+    par.graph = graph;
+    par.reverse = reverse;
+    par.colors = (int*)malloc((n > 0 ? (size_t)n : 1) * sizeof(int));
+    par.componentOf = scc->componentOf;
+    par.forward = (unsigned char*)calloc(n ? n : 1, sizeof(unsigned char));
+    par.backward = (unsigned char*)calloc(n ? n : 1, sizeof(unsigned char));
+    initTarjanState(&par.tarjan, n);
+    par.nextComponent = 0;
+    par.nextColor = 0;
+    pthread_mutex_init(&par.lock, NULL);
+    pthread_cond_init(&par.changed, NULL);
+    par.capacity = 64;
+    par.tasks = (struct SCCTask*)malloc(par.capacity * sizeof(struct SCCTask));
+    par.numTasks = 0;
+    par.busyWorkers = 0;
+    
+    if (n > 0) {
+        int* everyone = (int*)malloc(n * sizeof(int));
+        for (int u = 0; u < n; u++) {
+            everyone[u] = u;
+        }
+        pushSCCTask(&par, everyone, n);
+        runParallel(numThreads, parallelSCCWorker, &par);
+    }
+    scc->numComponents = par.nextComponent;
+    
+    pthread_mutex_destroy(&par.lock);
+    pthread_cond_destroy(&par.changed);
+    free(par.tasks);
+    free(par.colors);
+    free(par.forward);
+    free(par.backward);
+    freeTarjanState(&par.tarjan);
+    if (ownedReverse) freeGraph(ownedReverse);
+    finishSCCResult(scc);
+    return scc;
+}
+
+// Function to build the condensation DAG: one vertex per component and one
+// edge per distinct pair of components joined by a follow edge
+struct Graph* buildCondensation(const struct Graph* graph, const struct SCCResult* scc) {
+    int numComponents = scc->numComponents;
+    
+    // Group users by component (counting sort)
+    int* memberStart = (int*)calloc((size_t)numComponents + 1, sizeof(int));
+    int* members = (int*)malloc((graph->numUsers > 0 ? (size_t)graph->numUsers : 1) * sizeof(int));
+    for (int c = 0; c < numComponents; c++) {
+        memberStart[c + 1] = memberStart[c] + scc->componentSize[c];
+    }
+    int* fill = (int*)malloc(((size_t)numComponents + 1) * sizeof(int));
+    memcpy(fill, memberStart, ((size_t)numComponents + 1) * sizeof(int));
+    for (int u = 0; u < graph->numUsers; u++) {
+        members[fill[scc->componentOf[u]]++] = u;
+    }
+    
+    // lastSource[d] == c marks edge c -> d as already emitted
+    int* lastSource = (int*)malloc((numComponents > 0 ? (size_t)numComponents : 1) * sizeof(int));
+    for (int c = 0; c < numComponents; c++) {
+        lastSource[c] = -1;
+    }
+    
+    size_t capacity = 16, numDagEdges = 0;
+    int* src = (int*)malloc(capacity * sizeof(int));
+    int* dest = (int*)malloc(capacity * sizeof(int));
+    for (int c = 0; c < numComponents; c++) {
+        for (int i = memberStart[c]; i < memberStart[c + 1]; i++) {
+            int u = members[i];
+            for (size_t e = graph->rowOffsets[u]; e < graph->rowOffsets[u + 1]; e++) {
+                int d = scc->componentOf[graph->followees[e]];
+                if (d == c || lastSource[d] == c) continue;
+                lastSource[d] = c;
+                if (numDagEdges == capacity) {
+                    capacity *= 2;
+                    src = (int*)realloc(src, capacity * sizeof(int));
+                    dest = (int*)realloc(dest, capacity * sizeof(int));
+                }
+                src[numDagEdges] = c;
+                dest[numDagEdges] = d;
+                numDagEdges++;
+            }
+        }
+    }
+    
+    struct Graph* dag = createGraphFromEdges(numComponents, src, dest, numDagEdges);
+    free(src);
+    free(dest);
+    free(lastSource);
+    free(fill);
+    free(members);
+    free(memberStart);
+    return dag;
+}
+
+// Function to summarize the components and the condensed DAG
+void analyzeComponents(const struct SCCResult* scc, const struct Graph* dag, int listUsers) {
+    printf("=== STRONGLY CONNECTED COMPONENTS ===\n");
+    if (listUsers) {
+        for (int u = 0; u < scc->numUsers; u++) {
+            printf("User %d: component %d (size %d)\n", u, scc->componentOf[u],
+                   scc->componentSize[scc->componentOf[u]]);
+        }
+    }
+    
+    int largest = 0;
+    int singletons = 0;
+    for (int c = 0; c < scc->numComponents; c++) {
+        if (scc->componentSize[c] > scc->componentSize[largest]) largest = c;
+        if (scc->componentSize[c] == 1) singletons++;
+    }
+    printf("Components: %d (%d singletons)\n", scc->numComponents, singletons);
+    if (scc->numComponents > 0) {
+        printf("Largest component: %d with %d users\n", largest, scc->componentSize[largest]);
+    }
+    printf("Condensed DAG: %d vertices, %zu edges\n\n", dag->numUsers, dag->numEdges);
+}
+
+// ===================== INFLUENCE RANKING =====================
+//
+// Ranks users by follower count (in-degree) and by PageRank. PageRank runs
+// as a pull-based sparse matrix-vector product over the transposed graph:
+// each user sums the contributions of its followers, so every thread writes
+// only its own slice of the new rank vector and no atomics are needed.
+// Threads get slices with roughly equal numbers of in-edges.
+
+struct PageRankOptions {
+    int numThreads;
+    double damping;         // Probability of following an edge (usually 0.85)
+    double tolerance;       // Stop when the L1 change of the rank vector drops below this
+    int maxIterations;
+};
+
+struct InfluenceRanking {
+    int numUsers;
+    int* inDegree;          // Number of followers of each user
+    double* rank;           // PageRank score of each user (sums to 1)
+    int iterations;
+    double residual;        // L1 change in the last iteration
+    double seconds;         // Time spent in the power iteration
+};
+
+// Shared state of the parallel power iteration
+struct PageRankWork {
+    const struct Graph* graph;
+    const struct Graph* reverse;
+    const struct PageRankOptions* options;
+    double* rank;
+    double* nextRank;
+    double* contribution;   // rank[u] / outDegree(u)
+    int* sliceStart;        // Users [sliceStart[t], sliceStart[t + 1]) belong to thread t
+    double* partialDangling;
+    double* partialDelta;
+    double base;            // Teleport plus dangling share for this iteration
+};
+
+// Phase 1: per-user contribution and the rank mass of users who follow no one
+static void pageRankScatterTask(int threadId, int numThreads, void* arg) {
+    (void)numThreads;
+    struct PageRankWork* work = (struct PageRankWork*)arg;
+    double dangling = 0.0;
+    
+    for (int u = work->sliceStart[threadId]; u < work->sliceStart[threadId + 1]; u++) {
+        size_t outDegree = work->graph->rowOffsets[u + 1] - work->graph->rowOffsets[u];
+        if (outDegree == 0) {
+            dangling += work->rank[u];
+            work->contribution[u] = 0.0;
+        } else {
+            work->contribution[u] = work->rank[u] / (double)outDegree;
+        }
+    }
+    work->partialDangling[threadId] = dangling;
+}
+
+// Phase 2: pull follower contributions into the new rank of each user
+static void pageRankPullTask(int threadId, int numThreads, void* arg) {
+    (void)numThreads;
+    struct PageRankWork* work = (struct PageRankWork*)arg;
+    const struct Graph* reverse = work->reverse;
+    double damping = work->options->damping;
+    double delta = 0.0;
+    
+    for (int v = work->sliceStart[threadId]; v < work->sliceStart[threadId + 1]; v++) {
+        double sum = 0.0;
+        for (size_t e = reverse->rowOffsets[v]; e < reverse->rowOffsets[v + 1]; e++) {
+            sum += work->contribution[reverse->followees[e]];
+        }
+        double value = work->base + damping * sum;
+        delta += fabs(value - work->rank[v]);
+        work->nextRank[v] = value;
+    }
+    work->partialDelta[threadId] = delta;
+}
+
+// Function to rank users by in-degree and PageRank
+// reverse is the transposed graph (built here when NULL).
+struct InfluenceRanking* computeInfluenceRanking(const struct Graph* graph, const struct Graph* reverse,
+                                                 const struct PageRankOptions* options) {
+    int n = graph->numUsers;
+    int threads = options->numThreads > 0 ? options->numThreads : 1;
+    struct Graph* ownedReverse = NULL;
+    if (!reverse) reverse = ownedReverse = transposeGraph(graph);
+    
+    struct InfluenceRanking* ranking = (struct InfluenceRanking*)malloc(sizeof(struct InfluenceRanking));
+    ranking->numUsers = n;
+    ranking->inDegree = (int*)malloc((n > 0 ? (size_t)n : 1) * sizeof(int));
+    ranking->rank = (double*)malloc((n > 0 ? (size_t)n : 1) * sizeof(double));
+    ranking->iterations = 0;
+    ranking->residual = 0.0;
+    for (int v = 0; v < n; v++) {
+        ranking->inDegree[v] = (int)(reverse->rowOffsets[v + 1] - reverse->rowOffsets[v]);
+        ranking->rank[v] = 1.0 / n;
+    }
+    
+    struct PageRankWork work;
+    work.graph = graph;
+    work.reverse = reverse;
+    work.options = options;
+    work.rank = ranking->rank;
+    work.nextRank = (double*)malloc((n > 0 ? (size_t)n : 1) * sizeof(double));
+    work.contribution = (double*)malloc((n > 0 ? (size_t)n : 1) * sizeof(double));
+    work.sliceStart = (int*)malloc(((size_t)threads + 1) * sizeof(int));
+    work.partialDangling = (double*)calloc(threads, sizeof(double));
+    work.partialDelta = (double*)calloc(threads, sizeof(double));
+    
+    // Balance slices by in-edges (plus one per user, so empty rows count too)
+    size_t totalWork = reverse->numEdges + (size_t)n;
+    int user = 0;
+    work.sliceStart[0] = 0;
+    for (int t = 1; t < threads; t++) {
+        size_t target = totalWork * t / threads;
+        while (user < n && reverse->rowOffsets[user] + (size_t)user < target) user++;
+        work.sliceStart[t] = user;
+    }
+    work.sliceStart[threads] = n;
+    
+    double start = nowSeconds();
+    while (n > 0 && ranking->iterations < options->maxIterations) {
+        runParallel(threads, pageRankScatterTask, &work);
+        double dangling = 0.0;
+        for (int t = 0; t < threads; t++) {
+            dangling += work.partialDangling[t];
+        }
+        // Rank held by users who follow no one is spread evenly over everyone
+        work.base = (1.0 - options->damping) / n + options->damping * dangling / n;
+        
+        runParallel(threads, pageRankPullTask, &work);
+        double delta = 0.0;
+        for (int t = 0; t < threads; t++) {
+            delta += work.partialDelta[t];
+        }
+        
+        double* swap = work.rank;
+        work.rank = work.nextRank;
+        work.nextRank = swap;
+        ranking->iterations++;
+        ranking->residual = delta;
+        if (delta < options->tolerance) break;
+    }
+    ranking->seconds = nowSeconds() - start;
+    
+    // The final ranks may sit in either buffer
+    if (work.rank != ranking->rank) {
+        memcpy(ranking->rank, work.rank, (size_t)n * sizeof(double));
+        work.nextRank = work.rank;
+    }
+    
+    free(work.nextRank);
+    free(work.contribution);
+    free(work.sliceStart);
+    free(work.partialDangling);
+    free(work.partialDelta);
+    if (ownedReverse) freeGraph(ownedReverse);
+    return ranking;
+}
+
+void freeInfluenceRanking(struct InfluenceRanking* ranking) {
+    free(ranking->inDegree);
+    free(ranking->rank);
+    free(ranking);
+}
+
+// Function to place item at slot i of a min-heap ordered by score, moving
+// smaller children up as needed
+static void siftDownByScore(int* heap, int size, int i, int item, const double* score) {
+    for (;;) {
+        int smallest = -1;
+        double smallestScore = score[item];
+        int l = 2 * i + 1, r = 2 * i + 2;
+        if (l < size && score[heap[l]] < smallestScore) { smallest = l; smallestScore = score[heap[l]]; }
+        if (r < size && score[heap[r]] < smallestScore) smallest = r;
+        if (smallest < 0) break;
+        heap[i] = heap[smallest];
+        i = smallest;
+    }
+    heap[i] = item;
+}
+
+// Function to pick the topN users with the highest score, best first
+// Keeps a size-topN min-heap of candidates: O(n log topN). Returns the count found.
+int selectTopUsers(const double* score, int n, int topN, int* out) {
+    if (topN > n) topN = n;
+    if (topN <= 0) return 0;
+    int size = 0;
+    
+    for (int u = 0; u < n; u++) {
+        if (size < topN) {
+            // Sift the new user up
+            int i = size++;
+            while (i > 0 && score[out[(i - 1) / 2]] > score[u]) {
+                out[i] = out[(i - 1) / 2];
+                i = (i - 1) / 2;
+            }
+            out[i] = u;
+        } else if (score[u] > score[out[0]]) {
+            // Replace the weakest candidate
+            siftDownByScore(out, size, 0, u, score);
+        }
+    }
+    
+    // Repeatedly move the weakest to the back to get best-first order
+    for (int end = size - 1; end > 0; end--) {
+        int last = out[end];
+        out[end] = out[0];
+        siftDownByScore(out, end, 0, last, score);
+    }
+    return size;
+}
+
+// Function to print the topN users by PageRank alongside their follower counts
+void analyzeInfluenceRanking(const struct InfluenceRanking* ranking, int topN) {
+    printf("=== INFLUENCE RANKING (PageRank) ===\n");
+    printf("Converged after %d iterations (L1 change %.2e)\n", ranking->iterations, ranking->residual);
+    
+    int* top = (int*)malloc((topN > 0 ? (size_t)topN : 1) * sizeof(int));
+    int found = selectTopUsers(ranking->rank, ranking->numUsers, topN, top);
+    printf("Rank\tUser\tPageRank\tFollowers\n");
+    printf("----\t----\t--------\t---------\n");
+    for (int i = 0; i < found; i++) {
+        printf("%d\t%d\t%.6f\t%d\n", i + 1, top[i], ranking->rank[top[i]], ranking->inDegree[top[i]]);
+    }
+    printf("\n");
+    free(top);
+}
+
+// ===================== STREAMING FOLLOW / UNFOLLOW UPDATES =====================
+//
+// A mutable copy of the graph that absorbs batches of follow and unfollow
+// events and keeps two answers current without recomputing from scratch:
+//   - Reachability from a root user, kept as a spanning tree (parent links).
+//     A follow can only extend the reached set; an unfollow only matters if
+//     it removes a tree edge, and then only the subtree under it is
+//     re-examined and re-attached through other followers where possible.
+//   - SCC membership, plus a topological order of the condensation kept as
+//     a linked list of components with 64-bit labels (an order-maintenance
+//     list; a crowded spot is relabeled over a small window around it).
+//     A follow u -> v needs work only when comp(u) is ordered after comp(v):
+//     a bidirectional search, forward from v and backward from u, then
+//     visits only components ordered between the two. It either reorders
+//     the side it exhausted first or, if the sides meet, merges the
+//     components on the new cycle. An unfollow inside a component first
+//     checks, with a bidirectional search, whether the follower still
+//     reaches the followee; only if not is that one component re-split by
+//     Tarjan run directly over its members.
+// Follow edges are a set: repeated follows and unknown unfollows are ignored.
+
+enum FollowOp {
+    FOLLOW,
+    UNFOLLOW
+};
+
+struct FollowUpdate {
+    enum FollowOp op;
+    int src;                  // Follower
+    int dest;                 // Followee
+};
+
+// A component and its label in the topological order
+struct OrderEntry {
+    uint64_t label;
+    int component;
+};
+
+#define ORDER_LIMIT (UINT64_C(1) << 62)   // Labels stay below this bound
+#define KEEP_REACHED 1                      // The hub reaches this user
+#define KEEP_REACHES 2                      // This user reaches the hub
+#define SPLIT_MAX_HUBS 4                    // Hub choices tried before a full re-split
+#define PIVOT_MIN_SIZE 64                   // Follow searches enter components this large lazily
+
+// componentMark bits while a follow search runs
+#define DEFER_FORWARD 1
+#define DEFER_BACKWARD 2
+#define ENTER_FORWARD 4
+#define ENTER_BACKWARD 8
+
+// Growable list of user ids
+struct UserVector {
+    int* items;
+    int count;
+    int capacity;
+};
+
+// Open-addressing hash table from a (follower, followee) edge to its
+// positions in following[follower] and followers[followee] (linear probing,
+// power-of-two capacity, at most half full). Unfollows use backward-shift
+// deletion, so there are no tombstones and probes stay short.
+struct EdgeIndex {
+    uint64_t* keys;           // Packed (src, dest) + 1 (0 marks an empty slot)
+    int* followingPos;        // Index of dest in following[src]
+    int* followerPos;         // Index of src in followers[dest]
+    size_t capacity;
+    size_t count;
+};
+
+struct DynamicGraph {
+    int numUsers;
+    size_t numEdges;
+    struct UserVector* following;   // Out-edges of each user
+    struct UserVector* followers;   // In-edges of each user
+    struct EdgeIndex edgeIndex;     // Edge -> positions in the two lists above
+    
+    // Reachability from root
+    int root;
+    int* parent;              // Tree parent of each reached user (-1 for root and unreached)
+    unsigned char* reached;
+    int numReached;
+    
+    // SCC membership; ids are never reused, dead ids have size 0
+    int* componentOf;
+    int* componentSize;
+    int componentCapacity;
+    int nextComponentId;
+    int numComponents;
+    
+    // Topological order of live components (every edge between two
+    // components goes from a smaller label to a larger one)
+    uint64_t* orderLabel;
+    int* orderPrev;           // Neighbors in the order (-1 at either end)
+    int* orderNext;
+    unsigned char* componentMark;
+    
+    // Scratch space sized to the graph
+    int* queue;
+    int* list;
+    unsigned char* markA;
+    unsigned char* markB;
+    struct OrderEntry* componentList;   // Components found by a search, sorted by label
+    int* deferred;            // Large components a follow search has not entered yet
+    int* tarjanIndex;         // Preorder number + 1 while re-splitting (0 = unvisited);
+    int* tarjanLowLink;       // slot numUsers stands for the hub's whole component
+    int* callUsers;           // Explicit Tarjan call stack: user ...
+    int* callEdges;           // ... and next position in its following list
+    int* splitUsers;          // Users leaving a component after an unfollow
+    int numSplitUsers;
+    unsigned char* splitMark;
+    unsigned char* keepMark;  // KEEP_REACHED / KEEP_REACHES: checked against the hub
+    
+    // Cost accounting
+    size_t updatesApplied;
+    size_t usersTouched;      // Users visited by incremental repairs
+    double seconds;
+};
+
+static void pushUser(struct UserVector* vector, int user) {
+    if (vector->count == vector->capacity) {
+        vector->capacity = vector->capacity ? 2 * vector->capacity : 4;
+        vector->items = (int*)realloc(vector->items, vector->capacity * sizeof(int));
+    }
+    vector->items[vector->count++] = user;
+}
+
+static inline uint64_t edgeKey(int src, int dest) {
+    return (((uint64_t)(uint32_t)src << 32) | (uint32_t)dest) + 1;
+}
+
+static inline size_t edgeSlot(uint64_t key, size_t capacity) {
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    return (size_t)key & (capacity - 1);
+}
+
+// Function to find the slot holding src -> dest (SIZE_MAX if absent)
+static size_t edgeIndexFind(const struct EdgeIndex* index, int src, int dest) {
+    if (index->capacity == 0) return SIZE_MAX;
+    uint64_t key = edgeKey(src, dest);
+    size_t slot = edgeSlot(key, index->capacity);
+    while (index->keys[slot] != 0) {
+        if (index->keys[slot] == key) return slot;
+        slot = (slot + 1) & (index->capacity - 1);
+    }
+    return SIZE_MAX;
+}
+
+// Function to add src -> dest, which must not be present yet
+static void edgeIndexInsert(struct EdgeIndex* index, int src, int dest,
+                            int followingPos, int followerPos) {
+    if (2 * (index->count + 1) > index->capacity) {
+        size_t oldCapacity = index->capacity;
+        uint64_t* oldKeys = index->keys;
+        int* oldFollowing = index->followingPos;
+        int* oldFollower = index->followerPos;
+        index->capacity = oldCapacity ? 2 * oldCapacity : 64;
+        index->keys = (uint64_t*)calloc(index->capacity, sizeof(uint64_t));
+        index->followingPos = (int*)malloc(index->capacity * sizeof(int));
+        index->followerPos = (int*)malloc(index->capacity * sizeof(int));
+        for (size_t i = 0; i < oldCapacity; i++) {
+            if (oldKeys[i] == 0) continue;
+            size_t slot = edgeSlot(oldKeys[i], index->capacity);
+            while (index->keys[slot] != 0) slot = (slot + 1) & (index->capacity - 1);
+            index->keys[slot] = oldKeys[i];
+            index->followingPos[slot] = oldFollowing[i];
+            index->followerPos[slot] = oldFollower[i];
+        }
+        free(oldKeys);
+        free(oldFollowing);
+        free(oldFollower);
+    }
+    
+    uint64_t key = edgeKey(src, dest);
+    size_t slot = edgeSlot(key, index->capacity);
+    while (index->keys[slot] != 0) slot = (slot + 1) & (index->capacity - 1);
+    index->keys[slot] = key;
+    index->followingPos[slot] = followingPos;
+    index->followerPos[slot] = followerPos;
+    index->count++;
+}
+
+// Function to empty slot, shifting later entries of its probe run back so
+// every remaining key stays reachable from its home slot
+static void edgeIndexErase(struct EdgeIndex* index, size_t slot) {
+    size_t mask = index->capacity - 1;
+    size_t hole = slot;
+    for (size_t next = (slot + 1) & mask; index->keys[next] != 0; next = (next + 1) & mask) {
+        size_t home = edgeSlot(index->keys[next], index->capacity);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            index->keys[hole] = index->keys[next];
+            index->followingPos[hole] = index->followingPos[next];
+            index->followerPos[hole] = index->followerPos[next];
+            hole = next;
+        }
+    }
+    index->keys[hole] = 0;
+    index->count--;
+}
+
+static void edgeIndexFree(struct EdgeIndex* index) {
+    free(index->keys);
+    free(index->followingPos);
+    free(index->followerPos);
+    memset(index, 0, sizeof(*index));
+}
+
+// Function to add src -> dest to both adjacency lists and the edge index
+static void insertFollowEdge(struct DynamicGraph* dg, int src, int dest) {
+    pushUser(&dg->following[src], dest);
+    pushUser(&dg->followers[dest], src);
+    edgeIndexInsert(&dg->edgeIndex, src, dest,
+                    dg->following[src].count - 1, dg->followers[dest].count - 1);
+    dg->numEdges++;
+}
+
+// Function to remove src -> dest in O(1) (list order is not kept); returns 1 if found
+// The last entry of each list fills the gap, and its index slot is updated.
+static int eraseFollowEdge(struct DynamicGraph* dg, int src, int dest) {
+    size_t slot = edgeIndexFind(&dg->edgeIndex, src, dest);
+    if (slot == SIZE_MAX) return 0;
+    int i = dg->edgeIndex.followingPos[slot];
+    int j = dg->edgeIndex.followerPos[slot];
+    edgeIndexErase(&dg->edgeIndex, slot);
+    
+    struct UserVector* out = &dg->following[src];
+    int lastDest = out->items[--out->count];
+    if (i != out->count) {
+        out->items[i] = lastDest;
+        dg->edgeIndex.followingPos[edgeIndexFind(&dg->edgeIndex, src, lastDest)] = i;
+    }
+    struct UserVector* in = &dg->followers[dest];
+    int lastSrc = in->items[--in->count];
+    if (j != in->count) {
+        in->items[j] = lastSrc;
+        dg->edgeIndex.followerPos[edgeIndexFind(&dg->edgeIndex, lastSrc, dest)] = j;
+    }
+    dg->numEdges--;
+    return 1;
+}
+
+// Function to allocate a fresh component id
+static int newComponentId(struct DynamicGraph* dg) {
+    if (dg->nextComponentId == dg->componentCapacity) {
+        int oldCapacity = dg->componentCapacity;
+        dg->componentCapacity *= 2;
+        dg->componentSize = (int*)realloc(dg->componentSize, dg->componentCapacity * sizeof(int));
+        dg->orderLabel = (uint64_t*)realloc(dg->orderLabel, dg->componentCapacity * sizeof(uint64_t));
+        dg->orderPrev = (int*)realloc(dg->orderPrev, dg->componentCapacity * sizeof(int));
+        dg->orderNext = (int*)realloc(dg->orderNext, dg->componentCapacity * sizeof(int));
+        dg->componentMark = (unsigned char*)realloc(dg->componentMark, dg->componentCapacity);
+        memset(dg->componentMark + oldCapacity, 0, dg->componentCapacity - oldCapacity);
+    }
+    dg->componentSize[dg->nextComponentId] = 0;
+    return dg->nextComponentId++;
+}
+
+// Function to move a user into another component, keeping sizes and counts
+static void moveToComponent(struct DynamicGraph* dg, int user, int id) {
+    int old = dg->componentOf[user];
+    if (old == id) return;
+    if (old >= 0 && --dg->componentSize[old] == 0) dg->numComponents--;
+    if (dg->componentSize[id]++ == 0) dg->numComponents++;
+    dg->componentOf[user] = id;
+}
+
+// Function to extend the reached set from user, which has just become reached
+static void extendReach(struct DynamicGraph* dg, int user) {
+    int head = 0, tail = 0;
+    dg->queue[tail++] = user;
+    while (head < tail) {
+        int u = dg->queue[head++];
+        dg->usersTouched++;
+        for (int i = 0; i < dg->following[u].count; i++) {
+            int w = dg->following[u].items[i];
+            if (!dg->reached[w]) {
+                dg->reached[w] = 1;
+                dg->parent[w] = u;
+                dg->numReached++;
+                dg->queue[tail++] = w;
+            }
+        }
+    }
+}
+
+// Function to repair reachability after the tree edge parent[v] -> v was removed
+static void repairReachAfterCut(struct DynamicGraph* dg, int v) {
+    // Collect the subtree hanging below the removed edge and un-reach it
+    int count = 0;
+    dg->list[count++] = v;
+    dg->reached[v] = 0;
+    for (int i = 0; i < count; i++) {
+        int u = dg->list[i];
+        dg->usersTouched++;
+        for (int j = 0; j < dg->following[u].count; j++) {
+            int w = dg->following[u].items[j];
+            if (dg->reached[w] && dg->parent[w] == u) {
+                dg->reached[w] = 0;
+                dg->list[count++] = w;
+            }
+        }
+    }
+    dg->numReached -= count;
+    
+    // Re-attach subtree users that are followed by a user still reached
+    // from outside the subtree, then spread from them inside it
+    int head = 0, tail = 0;
+    for (int i = 0; i < count; i++) {
+        int u = dg->list[i];
+        dg->parent[u] = -1;
+        for (int j = 0; j < dg->followers[u].count; j++) {
+            int x = dg->followers[u].items[j];
+            if (dg->reached[x]) {
+                dg->reached[u] = 1;
+                dg->parent[u] = x;
+                dg->numReached++;
+                dg->queue[tail++] = u;
+                break;
+            }
+        }
+    }
+    while (head < tail) {
+        int u = dg->queue[head++];
+        for (int j = 0; j < dg->following[u].count; j++) {
+            int w = dg->following[u].items[j];
+            if (!dg->reached[w]) {
+                dg->reached[w] = 1;
+                dg->parent[w] = u;
+                dg->numReached++;
+                dg->queue[tail++] = w;
+            }
+        }
+    }
+}
+
+// Function to spread labels evenly over a window of components around anchor
+// The window doubles until its label range leaves gaps wider than the
+// window is long, so relabels stay rare and local.
+static void relabelOrder(struct DynamicGraph* dg, int anchor) {
+    int left = anchor, right = anchor, count = 1;
+    for (;;) {
+        int before = dg->orderPrev[left];
+        int after = dg->orderNext[right];
+        uint64_t low = before >= 0 ? dg->orderLabel[before] : 0;
+        uint64_t high = after >= 0 ? dg->orderLabel[after] : ORDER_LIMIT;
+        uint64_t gap = (high - low) / ((uint64_t)count + 1);
+        if (gap > (uint64_t)count || (before < 0 && after < 0)) {
+            uint64_t label = low;
+            for (int c = left; ; c = dg->orderNext[c]) {
+                label += gap;
+                dg->orderLabel[c] = label;
+                if (c == right) break;
+            }
+            return;
+        }
+        for (int step = count; step > 0; step--) {
+            if (dg->orderPrev[left] >= 0) {
+                left = dg->orderPrev[left];
+                count++;
+            }
+            if (dg->orderNext[right] >= 0) {
+                right = dg->orderNext[right];
+                count++;
+            }
+        }
+    }
+}
+
+// Function to take component c out of the topological order
+static void orderRemove(struct DynamicGraph* dg, int c) {
+    int before = dg->orderPrev[c];
+    int after = dg->orderNext[c];
+    if (before >= 0) dg->orderNext[before] = after;
+    if (after >= 0) dg->orderPrev[after] = before;
+    dg->orderPrev[c] = dg->orderNext[c] = -1;
+}
+
+// Function to place component c right after anchor in the topological order
+static void orderInsertAfter(struct DynamicGraph* dg, int anchor, int c) {
+    int after = dg->orderNext[anchor];
+    uint64_t high = after >= 0 ? dg->orderLabel[after] : ORDER_LIMIT;
+    if (high - dg->orderLabel[anchor] < 2) {
+        relabelOrder(dg, anchor);
+        high = after >= 0 ? dg->orderLabel[after] : ORDER_LIMIT;
+    }
+    dg->orderLabel[c] = dg->orderLabel[anchor] + (high - dg->orderLabel[anchor]) / 2;
+    dg->orderPrev[c] = anchor;
+    dg->orderNext[c] = after;
+    dg->orderNext[anchor] = c;
+    if (after >= 0) dg->orderPrev[after] = c;
+}
+
+// Function to place component c right before anchor in the topological order
+static void orderInsertBefore(struct DynamicGraph* dg, int anchor, int c) {
+    if (dg->orderPrev[anchor] >= 0) {
+        orderInsertAfter(dg, dg->orderPrev[anchor], c);
+        return;
+    }
+    if (dg->orderLabel[anchor] < 2) relabelOrder(dg, anchor);
+    dg->orderLabel[c] = dg->orderLabel[anchor] / 2;
+    dg->orderPrev[c] = -1;
+    dg->orderNext[c] = anchor;
+    dg->orderPrev[anchor] = c;
+}
+
+// Comparison function for qsort (ascending label)
+static int compareOrderEntries(const void* a, const void* b) {
+    uint64_t x = ((const struct OrderEntry*)a)->label;
+    uint64_t y = ((const struct OrderEntry*)b)->label;
+    return (x > y) - (x < y);
+}
+
+// Function to list the distinct components of users[0..count) in
+// dg->componentList, sorted by label; returns how many there are
+static int collectComponents(struct DynamicGraph* dg, const int* users, int count) {
+    int numFound = 0;
+    for (int i = 0; i < count; i++) {
+        int c = dg->componentOf[users[i]];
+        if (!dg->componentMark[c]) {
+            dg->componentMark[c] = 1;
+            dg->componentList[numFound].label = dg->orderLabel[c];
+            dg->componentList[numFound++].component = c;
+        }
+    }
+    for (int i = 0; i < numFound; i++) {
+        dg->componentMark[dg->componentList[i].component] = 0;
+    }
+    qsort(dg->componentList, (size_t)numFound, sizeof(struct OrderEntry), compareOrderEntries);
+    return numFound;
+}
+
+// Function to move the components listed in dg->componentList (sorted by
+// label) just after anchor, or just before it; emptied ones leave the order
+static void moveComponentsPast(struct DynamicGraph* dg, int numFound, int after, int anchor) {
+    for (int i = 0; i < numFound; i++) {
+        int c = dg->componentList[i].component;
+        orderRemove(dg, c);
+        if (dg->componentSize[c] == 0) continue;
+        if (after) {
+            orderInsertAfter(dg, anchor, c);
+            anchor = c;
+        } else {
+            orderInsertBefore(dg, anchor, c);
+        }
+    }
+}
+
+// Function to list the users of a finished search side that lie on a new
+// cycle, i.e. that also reach the anchor component (forward side) or are
+// reached from it (backward side); returns how many were marked and listed
+// Seeds are side users with an edge into (out of) the anchor component, and
+// the search grows from them inside the side only, never into the anchor.
+static int markCycleUsers(struct DynamicGraph* dg, const int* side, int sideCount, int forwardSide,
+                          int anchor, const unsigned char* sideMark, unsigned char* mark, int* out) {
+    int count = 0;
+    for (int i = 0; i < sideCount; i++) {
+        int x = side[i];
+        const struct UserVector* next = forwardSide ? &dg->following[x] : &dg->followers[x];
+        for (int j = 0; j < next->count; j++) {
+            if (dg->componentOf[next->items[j]] == anchor) {
+                mark[x] = 1;
+                out[count++] = x;
+                break;
+            }
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        int x = out[i];
+        const struct UserVector* next = forwardSide ? &dg->followers[x] : &dg->following[x];
+        dg->usersTouched++;
+        for (int j = 0; j < next->count; j++) {
+            int w = next->items[j];
+            if (sideMark[w] && !mark[w]) {
+                mark[w] = 1;
+                out[count++] = w;
+            }
+        }
+    }
+    return count;
+}
+
+// Function to merge into pivot, a component on a new cycle, everything on
+// that cycle between it and start
+// Forward: users start reaches among components ordered before pivot are
+// collected; those that also reach pivot join it, and the rest of their
+// components move just after it. Backward mirrors this from start to the
+// components ordered after pivot.
+static void absorbIntoPivot(struct DynamicGraph* dg, int forwardSide, int start, int pivot) {
+    uint64_t bound = dg->orderLabel[pivot];
+    int* side = forwardSide ? dg->queue : dg->list;
+    int* cycle = forwardSide ? dg->list : dg->queue;
+    unsigned char* sideMark = forwardSide ? dg->markA : dg->markB;
+    unsigned char* cycleMark = forwardSide ? dg->markB : dg->markA;
+    
+    int count = 0;
+    sideMark[start] = 1;
+    side[count++] = start;
+    for (int i = 0; i < count; i++) {
+        int x = side[i];
+        const struct UserVector* next = forwardSide ? &dg->following[x] : &dg->followers[x];
+        dg->usersTouched++;
+        for (int j = 0; j < next->count; j++) {
+            int w = next->items[j];
+            uint64_t label = dg->orderLabel[dg->componentOf[w]];
+            if (!sideMark[w] && (forwardSide ? label < bound : label > bound)) {
+                sideMark[w] = 1;
+                side[count++] = w;
+            }
+        }
+    }
+    
+    int numFound = collectComponents(dg, side, count);
+    int cycleCount = markCycleUsers(dg, side, count, forwardSide, pivot, sideMark, cycleMark, cycle);
+    for (int i = 0; i < cycleCount; i++) {
+        moveToComponent(dg, cycle[i], pivot);
+        cycleMark[cycle[i]] = 0;
+    }
+    moveComponentsPast(dg, numFound, forwardSide, pivot);
+    for (int i = 0; i < count; i++) {
+        sideMark[side[i]] = 0;
+    }
+}
+
+// State of the two searches run for a follow u -> v
+struct FollowSearch {
+    int* users[2];            // [0] forward from v, [1] backward from u
+    unsigned char* mark[2];
+    int head[2], tail[2];
+    int* deferred[2];         // One touched user per large component not entered yet
+    int deferredStart[2], deferredEnd[2];
+    uint64_t lower, upper;    // Labels of comp(v) and comp(u)
+    int cu, cv;
+    int pivot;                // A component found on the new cycle (-1 while unknown)
+};
+
+// Function to scan one user's edges for one side of a follow search
+// Users of components ordered between comp(v) and comp(u) are queued, except
+// that large components are only noted until the side has nothing else
+// left. Touching comp(u) (comp(v)), or anything the other side touched,
+// proves a cycle and records the pivot.
+static void expandSearchUser(struct DynamicGraph* dg, struct FollowSearch* search, int side, int x) {
+    const struct UserVector* next = side ? &dg->followers[x] : &dg->following[x];
+    unsigned char deferBit = side ? DEFER_BACKWARD : DEFER_FORWARD;
+    unsigned char enterBit = side ? ENTER_BACKWARD : ENTER_FORWARD;
+    unsigned char otherBits = side ? (DEFER_FORWARD | ENTER_FORWARD) : (DEFER_BACKWARD | ENTER_BACKWARD);
+    int target = side ? search->cv : search->cu;
+    dg->usersTouched++;
+    for (int j = 0; j < next->count; j++) {
+        int w = next->items[j];
+        int c = dg->componentOf[w];
+        if (c == target || search->mark[!side][w] || (dg->componentMark[c] & otherBits)) {
+            search->pivot = c;
+            return;
+        }
+        uint64_t label = dg->orderLabel[c];
+        if ((side ? label <= search->lower : label >= search->upper) || search->mark[side][w]) continue;
+        if (dg->componentSize[c] >= PIVOT_MIN_SIZE && !(dg->componentMark[c] & enterBit)) {
+            if (!(dg->componentMark[c] & deferBit)) {
+                dg->componentMark[c] |= deferBit;
+                search->deferred[side][search->deferredEnd[side]++] = w;
+            }
+            continue;
+        }
+        search->mark[side][w] = 1;
+        search->users[side][search->tail[side]++] = w;
+    }
+}
+
+// Function to start one side of a follow search at user start
+static void seedSearch(struct DynamicGraph* dg, struct FollowSearch* search, int side, int start) {
+    int c = dg->componentOf[start];
+    if (dg->componentSize[c] >= PIVOT_MIN_SIZE) {
+        dg->componentMark[c] |= side ? DEFER_BACKWARD : DEFER_FORWARD;
+        search->deferred[side][search->deferredEnd[side]++] = start;
+    } else {
+        search->mark[side][start] = 1;
+        search->users[side][search->tail[side]++] = start;
+    }
+}
+
+// Function to let one side of a follow search enter the large components it noted
+static void enterDeferred(struct DynamicGraph* dg, struct FollowSearch* search, int side) {
+    for (int i = search->deferredStart[side]; i < search->deferredEnd[side]; i++) {
+        int w = search->deferred[side][i];
+        dg->componentMark[dg->componentOf[w]] |= side ? ENTER_BACKWARD : ENTER_FORWARD;
+        if (!search->mark[side][w]) {
+            search->mark[side][w] = 1;
+            search->users[side][search->tail[side]++] = w;
+        }
+    }
+    search->deferredStart[side] = search->deferredEnd[side];
+}
+
+static long long deferredUsers(const struct DynamicGraph* dg, const struct FollowSearch* search, int side) {
+    long long total = 0;
+    for (int i = search->deferredStart[side]; i < search->deferredEnd[side]; i++) {
+        total += dg->componentSize[dg->componentOf[search->deferred[side][i]]];
+    }
+    return total;
+}
+
+// Function to update the SCCs and their order after the new edge u -> v
+// Nothing changes unless comp(u) is ordered after comp(v). Otherwise a
+// forward search from v and a backward search from u stay inside the
+// components ordered between the two and always grow the smaller side.
+//   - If one side is exhausted first, no cycle was closed: that side's
+//     components move, in order, just after comp(u) (or before comp(v)).
+//   - If the sides touch a common component P, the edge closed a cycle
+//     through P. Since v ~> P ~> u, adding u -> v has the same effect on
+//     reachability as adding P -> v and u -> P, so both are absorbed into
+//     P in turn, each with one search that stops at P. A large component
+//     on the cycle (say the giant one) is thus never walked through.
+static void updateComponentsAfterFollow(struct DynamicGraph* dg, int u, int v) {
+    int cu = dg->componentOf[u];
+    int cv = dg->componentOf[v];
+    if (cu == cv || dg->orderLabel[cu] < dg->orderLabel[cv]) return;
+    
+    struct FollowSearch search;
+    search.users[0] = dg->queue;
+    search.users[1] = dg->list;
+    search.mark[0] = dg->markA;
+    search.mark[1] = dg->markB;
+    search.deferred[0] = dg->deferred;
+    search.deferred[1] = dg->deferred + dg->numUsers / 2;
+    for (int side = 0; side < 2; side++) {
+        search.head[side] = search.tail[side] = 0;
+        search.deferredStart[side] = search.deferredEnd[side] = 0;
+    }
+    search.lower = dg->orderLabel[cv];
+    search.upper = dg->orderLabel[cu];
+    search.cu = cu;
+    search.cv = cv;
+    search.pivot = -1;
+    seedSearch(dg, &search, 0, v);
+    seedSearch(dg, &search, 1, u);
+    
+    int completeSide = -1;
+    while (search.pivot < 0) {
+        int queued[2], pending[2];
+        for (int side = 0; side < 2; side++) {
+            queued[side] = search.tail[side] - search.head[side];
+            pending[side] = search.deferredEnd[side] - search.deferredStart[side];
+        }
+        if (!queued[0] && !pending[0]) {
+            completeSide = 0;
+            break;
+        }
+        if (!queued[1] && !pending[1]) {
+            completeSide = 1;
+            break;
+        }
+        if (!queued[0] && !queued[1]) {
+            // Only large components are left: enter the smaller side's
+            enterDeferred(dg, &search, deferredUsers(dg, &search, 0) <= deferredUsers(dg, &search, 1) ? 0 : 1);
+            continue;
+        }
+        int side = !queued[0] ? 1 : !queued[1] ? 0 : (queued[0] <= queued[1] ? 0 : 1);
+        expandSearchUser(dg, &search, side, search.users[side][search.head[side]++]);
+    }
+    
+    for (int side = 0; side < 2; side++) {
+        for (int i = 0; i < search.deferredEnd[side]; i++) {
+            dg->componentMark[dg->componentOf[search.deferred[side][i]]] = 0;
+        }
+    }
+    if (completeSide >= 0) {
+        int numFound = collectComponents(dg, search.users[completeSide], search.tail[completeSide]);
+        moveComponentsPast(dg, numFound, completeSide == 0, completeSide == 0 ? cu : cv);
+    }
+    for (int side = 0; side < 2; side++) {
+        for (int i = 0; i < search.tail[side]; i++) {
+            search.mark[side][search.users[side][i]] = 0;
+        }
+    }
+    
+    if (search.pivot >= 0) {
+        int pivot = search.pivot;
+        if (pivot != cv) absorbIntoPivot(dg, 1, v, pivot);
+        if (pivot != cu) absorbIntoPivot(dg, 0, u, pivot);
+    }
+}
+
+// Function to split the users of dg->splitUsers out of component id
+// Tarjan runs on them directly, with stacks preallocated in dg. With a hub
+// (hub >= 0), the users left in id form one component, which Tarjan sees
+// as a single extra node (slot numUsers); parts popped before it (sinks)
+// go right after id in the topological order, later ones right before it,
+// and users that share its part stay in id. Without a hub the split users
+// are the whole component: the last part popped (a source) keeps id and
+// the others go right after it.
+static void splitComponentAfterUnfollow(struct DynamicGraph* dg, int id, int hub) {
+    const int* members = dg->splitUsers;
+    int count = dg->numSplitUsers;
+    int hubNode = dg->numUsers;
+    int* index = dg->tarjanIndex;
+    int* lowLink = dg->tarjanLowLink;
+    int* sccStack = dg->queue;
+    unsigned char* onStack = dg->markB;
+    int counter = 0, sccTop = 0, popped = 0;
+    int anchor = id;
+    int hubPopped = 0;
+    dg->usersTouched += count;
+    
+    // Edges out of the hub node: split users followed from inside id
+    int* hubTargets = dg->list;
+    int numHubTargets = 0;
+    if (hub >= 0) {
+        for (int i = 0; i < count; i++) {
+            int x = members[i];
+            for (int j = 0; j < dg->followers[x].count; j++) {
+                int w = dg->followers[x].items[j];
+                if (dg->componentOf[w] == id && !dg->splitMark[w]) {
+                    hubTargets[numHubTargets++] = x;
+                    break;
+                }
+            }
+        }
+    }
+    
+    for (int r = 0; r <= count; r++) {
+        int root = (r < count) ? members[r] : hubNode;
+        if (root == hubNode && hub < 0) break;
+        if (index[root]) continue;
+        
+        int callTop = 0;
+        index[root] = lowLink[root] = ++counter;
+        if (root != hubNode) onStack[root] = 1;
+        sccStack[sccTop++] = root;
+        dg->callUsers[callTop] = root;
+        dg->callEdges[callTop++] = 0;
+        
+        while (callTop > 0) {
+            int x = dg->callUsers[callTop - 1];
+            int e = dg->callEdges[callTop - 1];
+            int degree = (x == hubNode) ? numHubTargets : dg->following[x].count;
+            
+            if (e < degree) {
+                dg->callEdges[callTop - 1] = e + 1;
+                int w;
+                if (x == hubNode) {
+                    w = hubTargets[e];
+                } else {
+                    w = dg->following[x].items[e];
+                    if (dg->componentOf[w] != id) continue;
+                    if (!dg->splitMark[w]) {
+                        if (hub < 0) continue;
+                        w = hubNode;
+                    }
+                }
+                int wOnStack = (w == hubNode) ? !hubPopped : onStack[w];
+                
+                if (!index[w]) {
+                    index[w] = lowLink[w] = ++counter;
+                    if (w != hubNode) onStack[w] = 1;
+                    sccStack[sccTop++] = w;
+                    dg->callUsers[callTop] = w;
+                    dg->callEdges[callTop++] = 0;
+                } else if (wOnStack && index[w] < lowLink[x]) {
+                    lowLink[x] = index[w];
+                }
+                continue;
+            }
+            
+            // x is finished: it roots a part if no back edge escaped it
+            if (lowLink[x] == index[x]) {
+                int top = sccTop;
+                int member, hasHub = 0;
+                do {
+                    member = sccStack[--sccTop];
+                    if (member == hubNode) {
+                        hasHub = 1;
+                    } else {
+                        onStack[member] = 0;
+                        popped++;
+                    }
+                } while (member != x);
+                
+                if (hasHub) {
+                    hubPopped = 1;
+                } else if (hub >= 0 || popped < count) {
+                    int part = newComponentId(dg);
+                    if (hub >= 0 && hubPopped) {
+                        orderInsertBefore(dg, anchor, part);
+                        anchor = part;
+                    } else {
+                        orderInsertAfter(dg, id, part);
+                    }
+                    for (int i = sccTop; i < top; i++) {
+                        moveToComponent(dg, sccStack[i], part);
+                    }
+                }
+            }
+            callTop--;
+            if (callTop > 0) {
+                int parent = dg->callUsers[callTop - 1];
+                if (lowLink[x] < lowLink[parent]) lowLink[parent] = lowLink[x];
+            }
+        }
+    }
+    
+    for (int i = 0; i < count; i++) {
+        index[members[i]] = 0;
+        dg->splitMark[members[i]] = 0;
+    }
+    index[hubNode] = 0;
+    dg->numSplitUsers = 0;
+}
+
+static void applyFollow(struct DynamicGraph* dg, int u, int v) {
+    if (edgeIndexFind(&dg->edgeIndex, u, v) != SIZE_MAX) return;
+    insertFollowEdge(dg, u, v);
+    
+    if (dg->reached[u] && !dg->reached[v]) {
+        dg->reached[v] = 1;
+        dg->parent[v] = u;
+        dg->numReached++;
+        extendReach(dg, v);
+    }
+    updateComponentsAfterFollow(dg, u, v);
+}
+
+// Function to check whether from still reaches to inside component id,
+// avoiding users in dg->splitMark
+// Bidirectional search: forward from `from` and backward from `to`, always
+// growing the smaller frontier, until the two marked sets meet. If they
+// never meet, the side that ran out is closed (all users `from` reaches, or
+// all users reaching `to`): *closedSide says which (1 = forward), its users
+// are left in dg->queue (forward) or dg->list (backward), *closedCount
+// long, and *farthest is the last user the other side discovered.
+static int reachesWithin(struct DynamicGraph* dg, int from, int to, int id,
+                         int* closedSide, int* closedCount, int* farthest) {
+    if (from == to) return 1;
+    int* forward = dg->queue;   // Forward side grows from the front ...
+    int* backward = dg->list;   // ... backward side in its own buffer
+    int forwardHead = 0, forwardTail = 0, backwardHead = 0, backwardTail = 0;
+    int found = 0;
+    
+    dg->markA[from] = 1;
+    forward[forwardTail++] = from;
+    dg->markB[to] = 1;
+    backward[backwardTail++] = to;
+    
+    while (!found && forwardHead < forwardTail && backwardHead < backwardTail) {
+        int growForward = (forwardTail - forwardHead) <= (backwardTail - backwardHead);
+        int levelEnd = growForward ? forwardTail : backwardTail;
+        
+        while (!found && (growForward ? forwardHead : backwardHead) < levelEnd) {
+            int x = growForward ? forward[forwardHead++] : backward[backwardHead++];
+            const struct UserVector* next = growForward ? &dg->following[x] : &dg->followers[x];
+            dg->usersTouched++;
+            for (int j = 0; j < next->count; j++) {
+                int w = next->items[j];
+                if (dg->componentOf[w] != id || dg->splitMark[w]) continue;
+                if (growForward ? dg->markB[w] : dg->markA[w]) {
+                    found = 1;
+                    break;
+                }
+                if (growForward && !dg->markA[w]) {
+                    dg->markA[w] = 1;
+                    forward[forwardTail++] = w;
+                } else if (!growForward && !dg->markB[w]) {
+                    dg->markB[w] = 1;
+                    backward[backwardTail++] = w;
+                }
+            }
+        }
+    }
+    
+    if (!found) {
+        *closedSide = forwardHead == forwardTail;
+        *closedCount = *closedSide ? forwardTail : backwardTail;
+        *farthest = *closedSide ? backward[backwardTail - 1] : forward[forwardTail - 1];
+    }
+    for (int i = 0; i < forwardTail; i++) {
+        dg->markA[forward[i]] = 0;
+    }
+    for (int i = 0; i < backwardTail; i++) {
+        dg->markB[backward[i]] = 0;
+    }
+    return found;
+}
+
+// Function to test one user against the hub while splitting component id
+// reached = 1 asks whether the hub reaches w, 0 whether w reaches the hub.
+// On a no whose closed side is w's, that side (w's ancestors or
+// descendants, none connected to the hub either way) joins dg->splitUsers.
+// Returns 0 only when the hub's own side closed instead: the hub sits in a
+// small piece, and *nextHub suggests a better one.
+static int testAgainstHub(struct DynamicGraph* dg, int id, int hub, int w, int reached,
+                          int* numKept, int* nextHub) {
+    int closedSide, closedCount, farthest;
+    int connected = reached ? reachesWithin(dg, hub, w, id, &closedSide, &closedCount, &farthest)
+                            : reachesWithin(dg, w, hub, id, &closedSide, &closedCount, &farthest);
+    if (connected) {
+        if (!dg->keepMark[w]) dg->callUsers[(*numKept)++] = w;
+        dg->keepMark[w] |= reached ? KEEP_REACHED : KEEP_REACHES;
+        return 1;
+    }
+    if (closedSide == reached) {
+        *nextHub = farthest;
+        return 0;
+    }
+    const int* closed = closedSide ? dg->queue : dg->list;
+    for (int i = 0; i < closedCount; i++) {
+        dg->splitMark[closed[i]] = 1;
+        dg->splitUsers[dg->numSplitUsers++] = closed[i];
+    }
+    return 1;
+}
+
+// Function to find the users that leave component id after u -> v was cut,
+// relative to hub; returns 0 (and *nextHub) if the hub proves a poor choice
+// Everyone still reaches u and is reached from v, so the users the hub
+// no longer reaches hang off v through each other, and the users that no
+// longer reach the hub hang off u. Testing v, u and then the successors
+// (predecessors) of every user split so far therefore finds all of them.
+static int collectSplitUsers(struct DynamicGraph* dg, int id, int u, int v, int hub, int* nextHub) {
+    int numKept = 0, ok = 1;
+    dg->numSplitUsers = 0;
+    ok = testAgainstHub(dg, id, hub, v, 1, &numKept, nextHub) &&
+         (dg->splitMark[u] || testAgainstHub(dg, id, hub, u, 0, &numKept, nextHub));
+    for (int i = 0; ok && i < dg->numSplitUsers; i++) {
+        int x = dg->splitUsers[i];
+        for (int side = 0; ok && side < 2; side++) {
+            const struct UserVector* next = side ? &dg->followers[x] : &dg->following[x];
+            unsigned char flag = side ? KEEP_REACHES : KEEP_REACHED;
+            for (int j = 0; ok && j < next->count; j++) {
+                int w = next->items[j];
+                if (dg->componentOf[w] != id || dg->splitMark[w] || (dg->keepMark[w] & flag)) continue;
+                ok = testAgainstHub(dg, id, hub, w, !side, &numKept, nextHub);
+            }
+        }
+    }
+    for (int i = 0; i < numKept; i++) {
+        dg->keepMark[dg->callUsers[i]] = 0;
+    }
+    if (!ok) {
+        for (int i = 0; i < dg->numSplitUsers; i++) {
+            dg->splitMark[dg->splitUsers[i]] = 0;
+        }
+        dg->numSplitUsers = 0;
+    }
+    return ok;
+}
+
+static void applyUnfollow(struct DynamicGraph* dg, int u, int v) {
+    if (!eraseFollowEdge(dg, u, v)) return;
+    
+    if (dg->reached[v] && dg->parent[v] == u) {
+        repairReachAfterCut(dg, v);
+    }
+    
+    // A component survives losing u -> v exactly when u still reaches v
+    // inside it (any cycle through the edge can detour along that path)
+    int id = dg->componentOf[u];
+    int closedSide, closedCount, hub;
+    if (u == v || dg->componentOf[v] != id ||
+        reachesWithin(dg, u, v, id, &closedSide, &closedCount, &hub)) return;
+    
+    // Split off what the hub (a user the open side reached last, likely in
+    // the bulk of the component) is no longer strongly connected with
+    for (int attempt = 0; attempt < SPLIT_MAX_HUBS; attempt++) {
+        int nextHub;
+        if (collectSplitUsers(dg, id, u, v, hub, &nextHub)) {
+            splitComponentAfterUnfollow(dg, id, hub);
+            return;
+        }
+        hub = nextHub;
+    }
+    
+    // No hub held up: re-split the whole component, collecting its members
+    // through edges in either direction (it stays weakly connected via v ~> u)
+    int count = 0;
+    dg->splitUsers[count++] = u;
+    dg->splitMark[u] = 1;
+    for (int i = 0; i < count; i++) {
+        int x = dg->splitUsers[i];
+        for (int side = 0; side < 2; side++) {
+            const struct UserVector* next = side ? &dg->followers[x] : &dg->following[x];
+            for (int j = 0; j < next->count; j++) {
+                int w = next->items[j];
+                if (!dg->splitMark[w] && dg->componentOf[w] == id) {
+                    dg->splitMark[w] = 1;
+                    dg->splitUsers[count++] = w;
+                }
+            }
+        }
+    }
+    dg->numSplitUsers = count;
+    splitComponentAfterUnfollow(dg, id, -1);
+}
+
+// Function to create a mutable graph from a compacted CSR graph, tracking
+// reachability from root
+struct DynamicGraph* createDynamicGraph(const struct Graph* graph, int root) {
+    int n = graph->numUsers;
+    struct DynamicGraph* dg = (struct DynamicGraph*)calloc(1, sizeof(struct DynamicGraph));
+    dg->numUsers = n;
+    dg->following = (struct UserVector*)calloc(n, sizeof(struct UserVector));
+    dg->followers = (struct UserVector*)calloc(n, sizeof(struct UserVector));
+    
+    // Drop duplicate CSR edges in one pass per row: lastSource[v] == u
+    // means u -> v was already added
+    int* lastSource = (int*)malloc((n > 0 ? (size_t)n : 1) * sizeof(int));
+    for (int v = 0; v < n; v++) {
+        lastSource[v] = -1;
+    }
+    for (int u = 0; u < n; u++) {
+        for (size_t e = graph->rowOffsets[u]; e < graph->rowOffsets[u + 1]; e++) {
+            int v = graph->followees[e];
+            if (lastSource[v] == u) continue;
+            lastSource[v] = u;
+            insertFollowEdge(dg, u, v);
+        }
+    }
+    free(lastSource);
+    
+    dg->parent = (int*)malloc(n * sizeof(int));
+    dg->reached = (unsigned char*)calloc(n, sizeof(unsigned char));
+    dg->queue = (int*)malloc(n * sizeof(int));
+    dg->list = (int*)malloc(n * sizeof(int));
+    dg->markA = (unsigned char*)calloc(n, sizeof(unsigned char));
+    dg->markB = (unsigned char*)calloc(n, sizeof(unsigned char));
+    dg->componentList = (struct OrderEntry*)malloc((n > 0 ? (size_t)n : 1) * sizeof(struct OrderEntry));
+    dg->deferred = (int*)malloc((n > 0 ? (size_t)n : 1) * sizeof(int));
+    dg->tarjanIndex = (int*)calloc((size_t)n + 1, sizeof(int));
+    dg->tarjanLowLink = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    dg->callUsers = (int*)malloc((n > 0 ? (size_t)n : 1) * sizeof(int));
+    dg->callEdges = (int*)malloc((n > 0 ? (size_t)n : 1) * sizeof(int));
+    dg->splitUsers = (int*)malloc((n > 0 ? (size_t)n : 1) * sizeof(int));
+    dg->splitMark = (unsigned char*)calloc(n > 0 ? n : 1, sizeof(unsigned char));
+    dg->keepMark = (unsigned char*)calloc(n > 0 ? n : 1, sizeof(unsigned char));
+    for (int u = 0; u < n; u++) {
+        dg->parent[u] = -1;
+    }
+    
+    dg->root = root;
+    dg->reached[root] = 1;
+    dg->numReached = 1;
+    extendReach(dg, root);
+    
+    struct SCCResult* scc = computeSCCTarjan(graph);
+    dg->componentOf = scc->componentOf;
+    dg->componentSize = scc->componentSize;
+    dg->componentCapacity = scc->numComponents > 0 ? scc->numComponents : 1;
+    dg->nextComponentId = scc->numComponents;
+    dg->numComponents = scc->numComponents;
+    free(scc);
+    
+    // Tarjan ids are reverse topological, so the order runs from the
+    // highest id down to 0, spread evenly over the label range
+    int capacity = dg->componentCapacity;
+    dg->orderLabel = (uint64_t*)malloc(capacity * sizeof(uint64_t));
+    dg->orderPrev = (int*)malloc(capacity * sizeof(int));
+    dg->orderNext = (int*)malloc(capacity * sizeof(int));
+    dg->componentMark = (unsigned char*)calloc(capacity, sizeof(unsigned char));
+    uint64_t gap = ORDER_LIMIT / ((uint64_t)dg->numComponents + 1);
+    for (int c = 0; c < dg->numComponents; c++) {
+        dg->orderLabel[c] = (uint64_t)(dg->numComponents - c) * gap;
+        dg->orderPrev[c] = (c + 1 < dg->numComponents) ? c + 1 : -1;
+        dg->orderNext[c] = c - 1;
+    }
+    
+    dg->usersTouched = 0;
+    return dg;
+}
+
+// Function to apply a batch of follow/unfollow events in order
+void applyFollowUpdates(struct DynamicGraph* dg, const struct FollowUpdate* updates, int count) {
+    double start = nowSeconds();
+    for (int i = 0; i < count; i++) {
+        if (updates[i].op == FOLLOW) {
+            applyFollow(dg, updates[i].src, updates[i].dest);
+        } else {
+            applyUnfollow(dg, updates[i].src, updates[i].dest);
+        }
+    }
+    dg->updatesApplied += count;
+    dg->seconds += nowSeconds() - start;
+}
+
+// Function to copy the current edges into a compacted CSR graph
+struct Graph* snapshotDynamicGraph(const struct DynamicGraph* dg) {
+    struct Graph* graph = createGraph(dg->numUsers);
+    graph->followees = (int*)malloc((dg->numEdges ? dg->numEdges : 1) * sizeof(int));
+    size_t pos = 0;
+    for (int u = 0; u < dg->numUsers; u++) {
+        graph->rowOffsets[u] = pos;
+        for (int i = 0; i < dg->following[u].count; i++) {
+            graph->followees[pos++] = dg->following[u].items[i];
+        }
+    }
+    graph->rowOffsets[dg->numUsers] = pos;
+    graph->numEdges = pos;
+    return graph;
+}
+
+void freeDynamicGraph(struct DynamicGraph* dg) {
+    for (int u = 0; u < dg->numUsers; u++) {
+        free(dg->following[u].items);
+        free(dg->followers[u].items);
+    }
+    free(dg->following);
+    free(dg->followers);
+    edgeIndexFree(&dg->edgeIndex);
+    free(dg->parent);
+    free(dg->reached);
+    free(dg->componentOf);
+    free(dg->componentSize);
+    free(dg->queue);
+    free(dg->list);
+    free(dg->markA);
+    free(dg->markB);
+    free(dg->orderLabel);
+    free(dg->orderPrev);
+    free(dg->orderNext);
+    free(dg->componentMark);
+    free(dg->componentList);
+    free(dg->deferred);
+    free(dg->tarjanIndex);
+    free(dg->tarjanLowLink);
+    free(dg->callUsers);
+    free(dg->callEdges);
+    free(dg->splitUsers);
+    free(dg->splitMark);
+    free(dg->keepMark);
+    free(dg);
+}
+
+// Function to report the state and the amortized cost of the updates so far
+void analyzeDynamicGraph(const struct DynamicGraph* dg) {
+    printf("=== STREAMING UPDATE SUMMARY ===\n");
+    printf("Updates applied: %zu\n", dg->updatesApplied);
+    printf("Follow edges now: %zu\n", dg->numEdges);
+    printf("Users reachable from User %d: %d\n", dg->root, dg->numReached);
+    printf("Strongly connected components: %d\n", dg->numComponents);
+    if (dg->updatesApplied > 0) {
+        printf("Amortized cost per update: %.3f us, %.1f users touched\n",
+               dg->seconds * 1e6 / dg->updatesApplied,
+               (double)dg->usersTouched / dg->updatesApplied);
+    }
+    printf("\n");
+}
+
+// ===================== SYNTHETIC GRAPHS AND BENCHMARKS =====================
+//
+// Reproducible power-law follower graphs for benchmarking:
+//   - R-MAT (a Kronecker generator): each edge picks one quadrant of the
+//     adjacency matrix per level with probabilities a, b, c, d
+//   - Barabasi-Albert: each new user follows m existing users chosen in
+//     proportion to how often they already appear as an edge endpoint
+// Both are driven by a seeded splitmix64 generator, so a seed fixes the graph.
+
+#define RMAT_A 0.57
+#define RMAT_B 0.19
+#define RMAT_C 0.19
+
+// Uniform double in [0, 1)
+static double nextUniform(unsigned long long* state) {
+    return (nextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// A generated edge list (src[i] follows dest[i])
+struct EdgeList {
+    int numUsers;
+    size_t numEdges;
+    int* src;
+    int* dest;
+};
+
+void freeEdgeList(struct EdgeList* edges) {
+    free(edges->src);
+    free(edges->dest);
+    edges->src = NULL;
+    edges->dest = NULL;
+}
+
+// Function to generate an R-MAT graph with 2^scale users and numEdges edges
+struct EdgeList generateRMAT(int scale, size_t numEdges, uint64_t seed) {
+    struct EdgeList edges;
+    edges.numUsers = 1 << scale;
+    edges.numEdges = numEdges;
+    edges.src = (int*)malloc((numEdges ? numEdges : 1) * sizeof(int));
+    edges.dest = (int*)malloc((numEdges ? numEdges : 1) * sizeof(int));
+    
+    unsigned long long state = seed;
+    for (size_t e = 0; e < numEdges; e++) {
+        int u = 0, v = 0;
+        for (int level = 0; level < scale; level++) {
+            double r = nextUniform(&state);
+            int right = 0, down = 0;
+            if (r < RMAT_A) {
+                // top-left quadrant
+            } else if (r < RMAT_A + RMAT_B) {
+                right = 1;
+            } else if (r < RMAT_A + RMAT_B + RMAT_C) {
+                down = 1;
+            } else {
+                right = down = 1;
+            }
+            u = (u << 1) | down;
+            v = (v << 1) | right;
+        }
+        edges.src[e] = u;
+        edges.dest[e] = v;
+    }
+    return edges;
+}
+
+// Function to generate a Barabasi-Albert graph: numUsers users, each
+// following edgesPerUser earlier users picked by preferential attachment
+struct EdgeList generateBarabasiAlbert(int numUsers, int edgesPerUser, uint64_t seed) {
+    struct EdgeList edges;
+    int m = edgesPerUser;
+    edges.numUsers = numUsers;
+    edges.numEdges = numUsers > m ? (size_t)(numUsers - m - 1) * m + (size_t)m * (m + 1) : 0;
+    edges.src = (int*)malloc((edges.numEdges ? edges.numEdges : 1) * sizeof(int));
+    edges.dest = (int*)malloc((edges.numEdges ? edges.numEdges : 1) * sizeof(int));
+    if (edges.numEdges == 0) return edges;
+    
+    unsigned long long state = seed;
+    size_t count = 0;
+    
+    // Seed: the first m + 1 users all follow each other
+    for (int u = 0; u <= m; u++) {
+        for (int v = 0; v <= m; v++) {
+            if (u == v) continue;
+            edges.src[count] = u;
+            edges.dest[count] = v;
+            count++;
+        }
+    }
+    
+    // Picking a random endpoint of a random existing edge is picking a user
+    // with probability proportional to its degree
+    for (int u = m + 1; u < numUsers; u++) {
+        size_t existing = count;
+        for (int k = 0; k < m; k++) {
+            size_t pick = nextRandom(&state) % existing;
+            int target = (nextRandom(&state) & 1) ? edges.src[pick] : edges.dest[pick];
+            edges.src[count] = u;
+            edges.dest[count] = target;
+            count++;
+        }
+    }
+    return edges;
+}
+
+// Function to read the peak resident set size in MiB (0 if unavailable)
+double peakRSSMiB(void) {
+#ifdef _WIN32
+    return 0.0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0);   // bytes
+#else
+    return usage.ru_maxrss / 1024.0;              // KiB
+#endif
+#endif
+}
+
+static void printBenchRow(const char* generator, size_t edges, const char* phase, double seconds,
+                          size_t workEdges) {
+    printf("%s\t%zu\t%-12s\t%.4f\t\t%.2f\t\t%.1f\n", generator, edges, phase, seconds,
+           seconds > 0 ? workEdges / seconds / 1e6 : 0.0, peakRSSMiB());
+}
+
+// Function to benchmark build, DFS, reachability and influence ranking on
+// synthetic graphs with 10^4, 10^5, ... up to maxEdges edges
+void runBenchmarks(const char* generator, size_t maxEdges, uint64_t seed, int numThreads) {
+    printf("=== SOCIAL GRAPH BENCHMARK (%s, seed %llu, %d threads) ===\n",
+           generator, (unsigned long long)seed, numThreads);
+    printf("Graph\tEdges\tPhase\t\tSeconds\t\tM edges/s\tPeak RSS (MiB)\n");
+    printf("-----\t-----\t-----\t\t-------\t\t---------\t--------------\n");
+    
+    for (size_t target = 10000; target <= maxEdges; target *= 10) {
+        struct EdgeList edges;
+        double start = nowSeconds();
+        if (strcmp(generator, "ba") == 0) {
+            // 16 follows per user
+            edges = generateBarabasiAlbert((int)(target / 16) + 17, 16, seed);
+        } else {
+            // Average out-degree 16, as in the Graph500 R-MAT setting
+            int scale = 1;
+            while (((size_t)1 << scale) * 16 < target) scale++;
+            edges = generateRMAT(scale, target, seed);
+        }
+        printBenchRow(generator, edges.numEdges, "generate", nowSeconds() - start, edges.numEdges);
+        
+        start = nowSeconds();
+        struct Graph* graph = createGraphFromEdges(edges.numUsers, edges.src, edges.dest, edges.numEdges);
+        printBenchRow(generator, edges.numEdges, "build", nowSeconds() - start, edges.numEdges);
+        freeEdgeList(&edges);
+        
+        struct DFSContext* ctx = createDFSContext(graph->numUsers);
+        start = nowSeconds();
+        for (int u = 0; u < graph->numUsers; u++) {
+            if (!ctx->visited[u]) DFS(graph, ctx, u);
+        }
+        printBenchRow(generator, graph->numEdges, "dfs", nowSeconds() - start, ctx->edgesScanned);
+        freeDFSContext(ctx);
+        
+        int batch = graph->numUsers < 64 ? graph->numUsers : 64;
+        int sources[64];
+        for (int s = 0; s < batch; s++) {
+            sources[s] = s;
+        }
+        start = nowSeconds();
+        struct ReachabilityMatrix* matrix = computeMultiSourceReachability(graph, sources, batch);
+        printBenchRow(generator, graph->numEdges, "reach-64", nowSeconds() - start, graph->numEdges);
+        freeReachabilityMatrix(matrix);
+        
+        struct PageRankOptions options = {numThreads, 0.85, 1e-6, 100};
+        struct InfluenceRanking* ranking = computeInfluenceRanking(graph, NULL, &options);
+        printBenchRow(generator, graph->numEdges, "pagerank-it", ranking->seconds / (ranking->iterations ? ranking->iterations : 1),
+                      graph->numEdges);
+        freeInfluenceRanking(ranking);
+        
+        freeGraph(graph);
+    }
+    printf("\n");
+}
+
+// Function to run the built-in 5-user demonstration
+void runDemo(void) {
+    printf("=== SOCIAL MEDIA USER CONNECTION ANALYSIS ===\n");
+    printf("Using DFS with Timestamps to Identify Influential Users\n\n");
+    
+    // Create graph with 5 users (0, 1, 2, 3, 4)
+    struct Graph* graph = createGraph(5);
+    
+    // Add edges based on the given adjacency list
+    // 0 → 1, 2
+    addEdge(graph, 0, 1);
+    addEdge(graph, 0, 2);
+    
+    // 1 → 3
+    addEdge(graph, 1, 3);
+    
+    // 2 → 4
+    addEdge(graph, 2, 4);
+    
+    // 3 → (no one)
+    // 4 → (no one)
+    
+    // Pack the incremental lists into CSR form for traversal
+    compactGraph(graph);
+    
+    // Print the graph structure
+    printGraph(graph);
+    
+    // Create the traversal state for this graph
+    struct DFSContext* ctx = createDFSContext(graph->numUsers);
+    ctx->verbose = 1;
+    
+    // Perform DFS starting from user 0
+    printf("=== DFS TRAVERSAL WITH TIMESTAMPS ===\n");
+    printf("Starting DFS from User 0:\n\n");
+    
+    DFS(graph, ctx, 0);
+    
+    printf("\n");
+    
+    // Display results in tabular format
+    displayTimestamps(ctx);
+    
+    // Analyze influential users
+    analyzeInfluentialUsers(ctx);
+    
+    // Analyze reachability
+    analyzeReachability(ctx);
+    
+    // Answer "who can reach whom" for every user in one bit-parallel sweep
+    int sources[5] = {0, 1, 2, 3, 4};
+    struct ReachabilityMatrix* matrix = computeMultiSourceReachability(graph, sources, 5);
+    displayReachabilityMatrix(matrix);
+    freeReachabilityMatrix(matrix);
+    
+    // Group mutually reachable users, reusing the DFS finish times
+    struct SCCResult* scc = computeSCCKosaraju(graph, ctx);
+    struct Graph* dag = buildCondensation(graph, scc);
+    analyzeComponents(scc, dag, 1);
+    freeGraph(dag);
+    freeSCCResult(scc);
+    
+    // Rank users by follower count and PageRank
+    struct PageRankOptions options = {1, 0.85, 1e-10, 100};
+    struct InfluenceRanking* ranking = computeInfluenceRanking(graph, NULL, &options);
+    analyzeInfluenceRanking(ranking, 5);
+    freeInfluenceRanking(ranking);
+    
+    // Stream follow/unfollow events and keep reachability and SCCs current
+    struct DynamicGraph* dynamic = createDynamicGraph(graph, 0);
+    struct FollowUpdate updates[] = {
+        {FOLLOW, 3, 0},     // 3 → 0 closes the cycle 0 → 1 → 3 → 0
+        {UNFOLLOW, 0, 2},   // 2 and 4 are no longer reachable from 0
+        {FOLLOW, 4, 2},     // 2 ↔ 4 become mutually reachable
+    };
+    printf("=== STREAMING UPDATES ===\n");
+    printf("User 3 follows User 0, User 0 unfollows User 2, User 4 follows User 2\n\n");
+    applyFollowUpdates(dynamic, updates, 3);
+    for (int u = 0; u < dynamic->numUsers; u++) {
+        printf("User %d: %s from User 0, component %d\n", u,
+               dynamic->reached[u] ? "reachable" : "not reachable", dynamic->componentOf[u]);
+    }
+    printf("\n");
+    analyzeDynamicGraph(dynamic);
+    freeDynamicGraph(dynamic);
+    
+    // Free allocated memory
+    freeDFSContext(ctx);
+    freeGraph(graph);
+}
+
+// Function to print usage for the command-line modes
+void printUsage(const char* program) {
+    printf("Usage: %s                      run the 5-user demonstration\n", program);
+    printf("       %s --bench [rmat|ba] [--bench-max-edges N] [--seed S] [--threads N]\n", program);
+    printf("       %s --load EDGES [--cache IMAGE] [--threads N] [--reach-batch K]\n", program);
+    printf("       %*s [--dfs SOURCE [--verbose] [--report FILE [--format json|csv]]]\n", (int)strlen(program), "");
+    printf("       %*s [--scc tarjan|kosaraju|parallel] [--rank TOPN [--tolerance EPS]] [--stream UPDATES]\n", (int)strlen(program), "");
+    printf("  --bench GEN     time build/DFS/reachability/PageRank on R-MAT or Barabasi-Albert graphs\n");
+    printf("  --bench-max-edges N  largest benchmark graph, from 10^4 up (default 10^7)\n");
+    printf("  --seed S        generator seed (default 1)\n");
+    printf("  --load EDGES    binary edge file (EdgeFileHeader + u32/u64 id pairs)\n");
+    printf("  --cache IMAGE   CSR image to map instead of rebuilding (written on a miss)\n");
+    printf("  --threads N     worker threads for the build (default: one per CPU)\n");
+    printf("  --dfs SOURCE    timestamped DFS from SOURCE plus the timestamp analysis\n");
+    printf("  --verbose       print every DFS step (off by default)\n");
+    printf("  --report FILE   write timestamps, analysis, phase timings and counters\n");
+    printf("  --format FMT    report format: json (default) or csv\n");
+    printf("  --reach-batch K reachability from users 0..K-1 in one bit-parallel sweep\n");
+    printf("  --scc ENGINE    strongly connected components and condensed DAG\n");
+    printf("  --rank TOPN     top users by PageRank (parallel pull-based power iteration)\n");
+    printf("  --tolerance EPS PageRank convergence threshold on the L1 change (default 1e-6)\n");
+    printf("  --stream N      apply N random follow/unfollow events in batches of 1000\n");
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 1) {
+        runDemo();
+        return 0;
+    }
+    
+    const char* edgePath = NULL;
+    const char* cachePath = NULL;
+    int numThreads = defaultThreadCount();
+    int dfsSource = -1;
+    int verbose = 0;
+    const char* reportPath = NULL;
+    enum ReportFormat reportFormat = REPORT_JSON;
+    int reachBatch = 0;
+    const char* sccEngine = NULL;
+    int rankTop = 0;
+    double tolerance = 1e-6;
+    int streamUpdates = 0;
+    const char* benchGenerator = NULL;
+    size_t benchMaxEdges = 10000000;
+    uint64_t seed = 1;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--load") == 0 && i + 1 < argc) {
+            edgePath = argv[++i];
+        } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            cachePath = argv[++i];
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            numThreads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--dfs") == 0 && i + 1 < argc) {
+            dfsSource = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = 1;
+        } else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc) {
+            reportPath = argv[++i];
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            if (strcmp(name, "json") == 0) {
+                reportFormat = REPORT_JSON;
+            } else if (strcmp(name, "csv") == 0) {
+                reportFormat = REPORT_CSV;
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--reach-batch") == 0 && i + 1 < argc) {
+            reachBatch = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--scc") == 0 && i + 1 < argc) {
+            sccEngine = argv[++i];
+        } else if (strcmp(argv[i], "--rank") == 0 && i + 1 < argc) {
+            rankTop = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            tolerance = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--stream") == 0 && i + 1 < argc) {
+            streamUpdates = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--bench") == 0) {
+            benchGenerator = "rmat";
+            if (i + 1 < argc && (strcmp(argv[i + 1], "rmat") == 0 || strcmp(argv[i + 1], "ba") == 0)) {
+                benchGenerator = argv[++i];
+            }
+        } else if (strcmp(argv[i], "--bench-max-edges") == 0 && i + 1 < argc) {
+            benchMaxEdges = (size_t)strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (benchGenerator && numThreads >= 1) {
+        runBenchmarks(benchGenerator, benchMaxEdges, seed, numThreads);
+        return 0;
+    }
+    if (!edgePath || numThreads < 1 ||
+        (sccEngine && strcmp(sccEngine, "tarjan") != 0 && strcmp(sccEngine, "kosaraju") != 0 &&
+         strcmp(sccEngine, "parallel") != 0)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+    double start = nowSeconds();
+    int fromCache = 0;
+    struct Graph* graph = loadSocialGraph(edgePath, cachePath, numThreads, &fromCache);
+    if (!graph) return 1;
+    double loadTime = nowSeconds() - start;
+    
+    printf("=== SOCIAL GRAPH LOADED ===\n");
+    printf("Users: %d\n", graph->numUsers);
+    printf("Follow edges: %zu\n", graph->numEdges);
+    printf("Source: %s\n", fromCache ? "cached CSR image" : "edge file (parallel build)");
+    printf("Load time: %.3f s\n", loadTime);
+    
+    if (dfsSource >= 0 && dfsSource < graph->numUsers) {
+        struct RunMetrics metrics;
+        metrics.loadSeconds = loadTime;
+        
+        struct DFSContext* ctx = createDFSContext(graph->numUsers);
+        ctx->verbose = verbose;
+        start = nowSeconds();
+        DFS(graph, ctx, dfsSource);
+        metrics.traverseSeconds = nowSeconds() - start;
+        
+        start = nowSeconds();
+        struct TimestampAnalysis analysis = computeTimestampAnalysis(ctx);
+        metrics.analyzeSeconds = nowSeconds() - start;
+        
+        printf("\n=== DFS FROM USER %d ===\n", dfsSource);
+        printf("Reachable users: %d\n", analysis.reachableUsers);
+        printf("Most deeply nested user: %d (discovered at time %d)\n", analysis.deepestUser, analysis.maxDiscovery);
+        printf("Leaf users: %d\n", analysis.leafUsers);
+        printf("Edges scanned: %zu, max stack depth: %d\n", ctx->edgesScanned, ctx->maxStackDepth);
+        printf("Phases: load %.3f s, traverse %.3f s, analyze %.3f s\n",
+               metrics.loadSeconds, metrics.traverseSeconds, metrics.analyzeSeconds);
+        
+        if (reportPath) {
+            if (writeRunReport(reportPath, reportFormat, graph, dfsSource, ctx, &analysis, &metrics) == 0) {
+                printf("Report written to %s\n", reportPath);
+            } else {
+                fprintf(stderr, "Could not write report %s\n", reportPath);
+            }
+        }
+        freeDFSContext(ctx);
+    }
+    
+    if (reachBatch > 0) {
+        if (reachBatch > graph->numUsers) reachBatch = graph->numUsers;
+        int* sources = (int*)malloc(reachBatch * sizeof(int));
+        for (int s = 0; s < reachBatch; s++) {
+            sources[s] = s;
+        }
+        
+        start = nowSeconds();
+        struct ReachabilityMatrix* matrix = computeMultiSourceReachability(graph, sources, reachBatch);
+        double reachTime = nowSeconds() - start;
+        
+        printf("\n=== MULTI-SOURCE REACHABILITY (%d sources) ===\n", reachBatch);
+        for (int s = 0; s < reachBatch && s < 10; s++) {
+            printf("User %d reaches %d users\n", s, countReachable(matrix, s));
+        }
+        if (reachBatch > 10) printf("... (%d more sources)\n", reachBatch - 10);
+        printf("Sweep time: %.3f s\n", reachTime);
+        
+        freeReachabilityMatrix(matrix);
+        free(sources);
+    }
+    
+    if (sccEngine) {
+        start = nowSeconds();
+        struct SCCResult* scc;
+        if (strcmp(sccEngine, "tarjan") == 0) {
+            scc = computeSCCTarjan(graph);
+        } else if (strcmp(sccEngine, "kosaraju") == 0) {
+            struct DFSContext* ctx = createDFSContext(graph->numUsers);
+            scc = computeSCCKosaraju(graph, ctx);
+            freeDFSContext(ctx);
+        } else {
+            scc = computeSCCParallel(graph, NULL, numThreads);
+        }
+        double sccTime = nowSeconds() - start;
+        struct Graph* dag = buildCondensation(graph, scc);
+        
+        printf("\n");
+        analyzeComponents(scc, dag, 0);
+        printf("SCC time (%s): %.3f s\n", sccEngine, sccTime);
+        
+        freeGraph(dag);
+        freeSCCResult(scc);
+    }
+    
+    if (rankTop > 0) {
+        struct PageRankOptions options = {numThreads, 0.85, tolerance, 100};
+        struct InfluenceRanking* ranking = computeInfluenceRanking(graph, NULL, &options);
+        
+        printf("\n");
+        analyzeInfluenceRanking(ranking, rankTop);
+        printf("PageRank time: %.3f s (%.3f s per iteration, %.2f G edges/s)\n",
+               ranking->seconds, ranking->seconds / (ranking->iterations ? ranking->iterations : 1),
+               ranking->seconds > 0 ? graph->numEdges * (double)ranking->iterations / ranking->seconds / 1e9 : 0.0);
+        freeInfluenceRanking(ranking);
+    }
+    
+    if (streamUpdates > 0 && graph->numUsers > 0) {
+        start = nowSeconds();
+        struct DynamicGraph* dynamic = createDynamicGraph(graph, 0);
+        printf("\nDynamic graph built in %.3f s\n", nowSeconds() - start);
+        
+        // Random events: half follows of random pairs, half unfollows of
+        // existing edges picked through a random follower
+        const int batchSize = 1000;
+        struct FollowUpdate* batch = (struct FollowUpdate*)malloc(batchSize * sizeof(struct FollowUpdate));
+        srand(12345);
+        for (int done = 0; done < streamUpdates; ) {
+            int count = 0;
+            while (count < batchSize && done + count < streamUpdates) {
+                int u = rand() % graph->numUsers;
+                if (rand() % 2 == 0 || dynamic->following[u].count == 0) {
+                    batch[count].op = FOLLOW;
+                    batch[count].src = u;
+                    batch[count].dest = rand() % graph->numUsers;
+                } else {
+                    batch[count].op = UNFOLLOW;
+                    batch[count].src = u;
+                    batch[count].dest = dynamic->following[u].items[rand() % dynamic->following[u].count];
+                }
+                count++;
+            }
+            applyFollowUpdates(dynamic, batch, count);
+            done += count;
+        }
+        free(batch);
+        
+        analyzeDynamicGraph(dynamic);
+        freeDynamicGraph(dynamic);
+    }
     
+    freeGraph(graph);
     return 0;
 }
\ No newline at end of file
@@ -1,7 +1,50 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
 #include <time.h>
 
+#include "../common/parallel.h"
+#include "../common/support.h"
+
+// Step-by-step tracing of the demonstration QuickSelect (partition,
+// quickSelect, findKthLargest). Traces can be switched off at run time
+// (the benchmarks do so while timing these routines), or compiled out with
+// -DQUICKSELECT_TRACE=0; the production selection path never prints.
+#ifndef QUICKSELECT_TRACE
+#define QUICKSELECT_TRACE 1
+#endif
+
+#if QUICKSELECT_TRACE
+static int traceEnabled = 1;
+#define TRACE(...) do { if (traceEnabled) printf(__VA_ARGS__); } while (0)
+#else
+#define TRACE(...) ((void)0)
+#endif
+
+// Function to switch tracing on or off; returns the previous setting
+static int setTracing(int enabled) {
+#if QUICKSELECT_TRACE
+    int previous = traceEnabled;
+    traceEnabled = enabled;
+    return previous;
+#else
+    (void)enabled;
+    return 0;
+#endif
+}
+
 // Function to swap two elements
 void swap(int* a, int* b) {
     int temp = *a;
@@ -25,7 +68,7 @@ int partition(int arr[], int low, int high) {
     int pivot = arr[high];
     int i = low - 1; // Index of smaller element
     
-    printf("    Partitioning range [%d, %d] with pivot = %d\n", low, high, pivot);
+    TRACE("    Partitioning range [%d, %d] with pivot = %d\n", low, high, pivot);
     
     for (int j = low; j < high; j++) {
         // If current element is greater than or equal to pivot
@@ -39,12 +82,16 @@ int partition(int arr[], int low, int high) {
     // Place pivot in its correct position
     swap(&arr[i + 1], &arr[high]);
     
-    printf("    After partition: ");
-    for (int k = low; k <= high; k++) {
-        if (k == i + 1) printf("[%d] ", arr[k]);
-        else printf("%d ", arr[k]);
+#if QUICKSELECT_TRACE
+    if (traceEnabled) {
+        printf("    After partition: ");
+        for (int k = low; k <= high; k++) {
+            if (k == i + 1) printf("[%d] ", arr[k]);
+            else printf("%d ", arr[k]);
+        }
+        printf("\n");
     }
-    printf("\n");
+#endif
     
     return i + 1; // Return position of pivot
 }
@@ -52,7 +99,7 @@ int partition(int arr[], int low, int high) {
 // QuickSelect function to find kth largest element
 // Uses divide and conquer approach
 int quickSelect(int arr[], int low, int high, int k) {
-    printf("  QuickSelect called: range [%d, %d], looking for %d%s largest\n", 
+    TRACE("  QuickSelect called: range [%d, %d], looking for %d%s largest\n", 
            low, high, k, (k == 1) ? "st" : (k == 2) ? "nd" : (k == 3) ? "rd" : "th");
     
     if (low <= high) {
@@ -62,23 +109,23 @@ int quickSelect(int arr[], int low, int high, int k) {
         // Calculate the position of pivot in descending order (1-indexed)
         int pivotPosition = pivotIndex - low + 1;
         
-        printf("    Pivot at index %d is in position %d\n", pivotIndex, pivotPosition);
+        TRACE("    Pivot at index %d is in position %d\n", pivotIndex, pivotPosition);
         
         // If pivot is the kth largest element
         if (pivotPosition == k) {
-            printf("    Found! %d%s largest element is %d\n", 
+            TRACE("    Found! %d%s largest element is %d\n", 
                    k, (k == 1) ? "st" : (k == 2) ? "nd" : (k == 3) ? "rd" : "th", arr[pivotIndex]);
             return arr[pivotIndex];
         }
         // If kth largest is in the left partition
         else if (pivotPosition > k) {
-            printf("    Searching left partition for %d%s largest\n", 
+            TRACE("    Searching left partition for %d%s largest\n", 
                    k, (k == 1) ? "st" : (k == 2) ? "nd" : (k == 3) ? "rd" : "th");
             return quickSelect(arr, low, pivotIndex - 1, k);
         }
         // If kth largest is in the right partition
         else {
-            printf("    Searching right partition for %d%s largest\n", 
+            TRACE("    Searching right partition for %d%s largest\n", 
                    k - pivotPosition, (k - pivotPosition == 1) ? "st" : (k - pivotPosition == 2) ? "nd" : (k - pivotPosition == 3) ? "rd" : "th");
             return quickSelect(arr, pivotIndex + 1, high, k - pivotPosition);
         }
@@ -87,9 +134,89 @@ int quickSelect(int arr[], int low, int high, int k) {
     return -1; // Should never reach here for valid input
 }
 
+// Three-way (Dutch national flag) partition for QuickSelect
+// Splits arr[low..high] around pivot = arr[high] into
+//   [low, *equalStart)       elements greater than the pivot
+//   [*equalStart, *equalEnd] elements equal to the pivot
+//   (*equalEnd, high]        elements smaller than the pivot
+// so every copy of the pivot is settled in one pass.
+void partition3Way(int arr[], int low, int high, int* equalStart, int* equalEnd) {
+    int pivot = arr[high];
+    int lt = low;    // Next slot for a greater element
+    int i = low;     // Current element
+    int gt = high;   // Next slot (from the right) for a smaller element
+    
+    TRACE("    Three-way partitioning range [%d, %d] with pivot = %d\n", low, high, pivot);
+    
+    while (i <= gt) {
+        if (arr[i] > pivot) {
+            swap(&arr[lt], &arr[i]);
+            lt++;
+            i++;
+        } else if (arr[i] < pivot) {
+            swap(&arr[i], &arr[gt]);
+            gt--;
+        } else {
+            i++;
+        }
+    }
+    
+#if QUICKSELECT_TRACE
+    if (traceEnabled) {
+        printf("    After partition: ");
+        for (int k = low; k <= high; k++) {
+            if (k == lt) printf("[");
+            printf("%d", arr[k]);
+            if (k == gt) printf("]");
+            printf(" ");
+        }
+        printf("\n");
+    }
+#endif
+    
+    *equalStart = lt;
+    *equalEnd = gt;
+}
+
+// QuickSelect with three-way partitioning (fat pivot)
+// Stops as soon as k falls inside the run of elements equal to the pivot,
+// so inputs with few distinct values finish in a handful of passes instead
+// of peeling one duplicate off per call.
+int quickSelect3Way(int arr[], int low, int high, int k) {
+    TRACE("  QuickSelect (3-way) called: range [%d, %d], looking for %d%s largest\n", 
+           low, high, k, (k == 1) ? "st" : (k == 2) ? "nd" : (k == 3) ? "rd" : "th");
+    
+    while (low <= high) {
+        int equalStart, equalEnd;
+        partition3Way(arr, low, high, &equalStart, &equalEnd);
+        
+        // Positions of the equal run in descending order (1-indexed)
+        int firstPosition = equalStart - low + 1;
+        int lastPosition = equalEnd - low + 1;
+        
+        TRACE("    Pivot occupies positions %d..%d\n", firstPosition, lastPosition);
+        
+        if (k < firstPosition) {
+            TRACE("    Searching left partition for %d%s largest\n", 
+                   k, (k == 1) ? "st" : (k == 2) ? "nd" : (k == 3) ? "rd" : "th");
+            high = equalStart - 1;
+        } else if (k > lastPosition) {
+            k -= lastPosition;
+            TRACE("    Searching right partition for %d%s largest\n", 
+                   k, (k == 1) ? "st" : (k == 2) ? "nd" : (k == 3) ? "rd" : "th");
+            low = equalEnd + 1;
+        } else {
+            TRACE("    Found! k lies in the equal range, value %d\n", arr[equalStart]);
+            return arr[equalStart];
+        }
+    }
+    
+    return -1; // Should never reach here for valid input
+}
+
 // Function to find kth largest element (main interface)
 int findKthLargest(int arr[], int n, int k) {
-    printf("=== FINDING %d%s LARGEST ELEMENT ===\n", 
+    TRACE("=== FINDING %d%s LARGEST ELEMENT ===\n", 
            k, (k == 1) ? "ST" : (k == 2) ? "ND" : (k == 3) ? "RD" : "TH");
     
     // Create a copy of array to preserve original
@@ -98,7 +225,9 @@ int findKthLargest(int arr[], int n, int k) {
         tempArr[i] = arr[i];
     }
     
-    printArray(tempArr, n, "Original array");
+#if QUICKSELECT_TRACE
+    if (traceEnabled) printArray(tempArr, n, "Original array");
+#endif
     
     // Use QuickSelect to find kth largest
     int result = quickSelect(tempArr, 0, n - 1, k);
@@ -107,85 +236,2595 @@ int findKthLargest(int arr[], int n, int k) {
     return result;
 }
 
-// Function to demonstrate with step-by-step execution
-void demonstrateAlgorithm(int arr[], int n, int k) {
-    printf("=== ALGORITHM DEMONSTRATION ===\n");
-    printf("Problem: Find the %d%s largest element in the array\n", 
-           k, (k == 1) ? "st" : (k == 2) ? "nd" : (k == 3) ? "rd" : "th");
-    printf("Approach: QuickSelect (Divide and Conquer)\n\n");
+// ===================== PARTITION KERNELS =====================
+//
+// A partition kernel moves every element greater than `threshold` to the
+// front of arr[0..n-1] and returns how many there are. The element order on
+// each side is unspecified. Three implementations share that contract:
+//   - scalar: BlockQuicksort-style block partition; misplaced offsets are
+//     collected without branches, then swapped in pairs
+//   - AVX2: 8 lanes per step, compaction through a permutation lookup table
+//   - AVX-512: 16 lanes per step, native compress instructions
+// The SIMD kernels work in place: one vector from each end is held in a
+// register, which frees 2 vectors of space that the compressed stores fill.
+// The best kernel for the running CPU is picked once at startup.
+
+#define PARTITION_BLOCK 128
+
+typedef size_t (*PartitionKernel)(int* arr, size_t n, int threshold);
+
+// Function to partition with a branchless Lomuto scan (used for short ranges)
+static size_t partitionGreaterLomuto(int* arr, size_t n, int threshold) {
+    size_t store = 0;
+    for (size_t i = 0; i < n; i++) {
+        int value = arr[i];
+        arr[i] = arr[store];
+        arr[store] = value;
+        store += (value > threshold);
+    }
+    return store;
+}
+
+// Function to partition with the branchless block scheme (portable fallback)
+static size_t partitionGreaterScalar(int* arr, size_t n, int threshold) {
+    unsigned char offsetsLeft[PARTITION_BLOCK];
+    unsigned char offsetsRight[PARTITION_BLOCK];
+    size_t left = 0, right = n;              // Unclassified range is [left, right)
+    int numLeft = 0, numRight = 0;
+    int startLeft = 0, startRight = 0;
     
-    printArray(arr, n, "Input array");
-    printf("k = %d\n\n", k);
+    while (right - left > 2 * PARTITION_BLOCK) {
+        // Left block: record elements that belong on the right (<= threshold)
+        if (numLeft == 0) {
+            startLeft = 0;
+            for (int i = 0; i < PARTITION_BLOCK; i++) {
+                offsetsLeft[numLeft] = (unsigned char)i;
+                numLeft += (arr[left + i] <= threshold);
+            }
+        }
+        // Right block: record elements that belong on the left (> threshold)
+        if (numRight == 0) {
+            startRight = 0;
+            for (int i = 0; i < PARTITION_BLOCK; i++) {
+                offsetsRight[numRight] = (unsigned char)i;
+                numRight += (arr[right - 1 - i] > threshold);
+            }
+        }
+        
+        int pairs = (numLeft < numRight) ? numLeft : numRight;
+        for (int j = 0; j < pairs; j++) {
+            swap(&arr[left + offsetsLeft[startLeft + j]],
+                 &arr[right - 1 - offsetsRight[startRight + j]]);
+        }
+        numLeft -= pairs;
+        numRight -= pairs;
+        startLeft += pairs;
+        startRight += pairs;
+        
+        if (numLeft == 0) left += PARTITION_BLOCK;
+        if (numRight == 0) right -= PARTITION_BLOCK;
+    }
     
-    int result = findKthLargest(arr, n, k);
+    // At most two blocks remain (one possibly half-processed)
+    return left + partitionGreaterLomuto(arr + left, right - left, threshold);
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_X86_PARTITION_KERNELS 1
+#include <immintrin.h>
+
+// Lane permutation that moves the lanes selected by an 8-bit mask to the
+// front (in order) and the remaining lanes behind them
+static int compressTableAVX2[256][8];
+static pthread_once_t compressTableOnce = PTHREAD_ONCE_INIT;
+
+// Function to fill the AVX2 compaction table
+static void initCompressTableAVX2(void) {
+    for (int mask = 0; mask < 256; mask++) {
+        int out = 0;
+        for (int lane = 0; lane < 8; lane++) {
+            if (mask & (1 << lane)) compressTableAVX2[mask][out++] = lane;
+        }
+        for (int lane = 0; lane < 8; lane++) {
+            if (!(mask & (1 << lane))) compressTableAVX2[mask][out++] = lane;
+        }
+    }
+}
+
+// Function to place the leftover elements of a SIMD partition one by one
+// (they were copied out first, so the gap between left and right is free)
+static size_t placeRemaining(int* arr, size_t left, size_t right,
+                             const int* pending, size_t count, int threshold) {
+    for (size_t i = 0; i < count; i++) {
+        int value = pending[i];
+        if (value > threshold) {
+            arr[left++] = value;
+        } else {
+            arr[--right] = value;
+        }
+    }
+    return left;
+}
+
+// Function to partition 8 lanes at a time with AVX2
+__attribute__((target("avx2,popcnt")))
+static size_t partitionGreaterAVX2(int* arr, size_t n, int threshold) {
+    const size_t lanes = 8;
+    if (n < 4 * lanes) return partitionGreaterLomuto(arr, n, threshold);
     
-    printf("\n=== VERIFICATION ===\n");
-    // Sort array to verify result
-    int* sortedArr = (int*)malloc(n * sizeof(int));
-    for (int i = 0; i < n; i++) {
-        sortedArr[i] = arr[i];
+    const __m256i pivot = _mm256_set1_epi32(threshold);
+    __m256i first = _mm256_loadu_si256((const __m256i*)arr);
+    __m256i last = _mm256_loadu_si256((const __m256i*)(arr + n - lanes));
+    size_t left = 0, right = n;                      // Write cursors
+    size_t readLeft = lanes, readRight = n - lanes;  // Unread range
+    
+    while (readRight - readLeft >= lanes) {
+        // Read from the side with less free space so both stores always fit
+        __m256i v;
+        if (readLeft - left <= right - readRight) {
+            v = _mm256_loadu_si256((const __m256i*)(arr + readLeft));
+            readLeft += lanes;
+        } else {
+            readRight -= lanes;
+            v = _mm256_loadu_si256((const __m256i*)(arr + readRight));
+        }
+        
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, pivot)));
+        int greater = __builtin_popcount((unsigned)mask);
+        __m256i order = _mm256_loadu_si256((const __m256i*)compressTableAVX2[mask]);
+        __m256i packed = _mm256_permutevar8x32_epi32(v, order);
+        
+        // Greater lanes land at left, the rest end exactly at right
+        _mm256_storeu_si256((__m256i*)(arr + left), packed);
+        _mm256_storeu_si256((__m256i*)(arr + right - lanes), packed);
+        left += greater;
+        right -= lanes - greater;
     }
     
-    // Simple bubble sort for verification
-    for (int i = 0; i < n - 1; i++) {
-        for (int j = 0; j < n - i - 1; j++) {
-            if (sortedArr[j] < sortedArr[j + 1]) {
-                swap(&sortedArr[j], &sortedArr[j + 1]);
+    int pending[3 * 8];
+    size_t count = readRight - readLeft;
+    memcpy(pending, arr + readLeft, count * sizeof(int));
+    _mm256_storeu_si256((__m256i*)(pending + count), first);
+    _mm256_storeu_si256((__m256i*)(pending + count + lanes), last);
+    return placeRemaining(arr, left, right, pending, count + 2 * lanes, threshold);
+}
+
+// Function to partition 16 lanes at a time with AVX-512 compress
+__attribute__((target("avx512f,popcnt")))
+static size_t partitionGreaterAVX512(int* arr, size_t n, int threshold) {
+    const size_t lanes = 16;
+    if (n < 4 * lanes) return partitionGreaterLomuto(arr, n, threshold);
+    
+    const __m512i pivot = _mm512_set1_epi32(threshold);
+    __m512i first = _mm512_loadu_si512(arr);
+    __m512i last = _mm512_loadu_si512(arr + n - lanes);
+    size_t left = 0, right = n;
+    size_t readLeft = lanes, readRight = n - lanes;
+    
+    while (readRight - readLeft >= lanes) {
+        __m512i v;
+        if (readLeft - left <= right - readRight) {
+            v = _mm512_loadu_si512(arr + readLeft);
+            readLeft += lanes;
+        } else {
+            readRight -= lanes;
+            v = _mm512_loadu_si512(arr + readRight);
+        }
+        
+        __mmask16 mask = _mm512_cmpgt_epi32_mask(v, pivot);
+        int greater = __builtin_popcount((unsigned)mask);
+        // Compress in registers and store whole vectors (memory-destination
+        // compress-store is microcoded on several cores); the free space
+        // absorbs the unused lanes exactly as in the AVX2 kernel
+        __m512i packedGreater = _mm512_maskz_compress_epi32(mask, v);
+        __m512i packedRest = _mm512_maskz_expand_epi32((__mmask16)(0xFFFFu << greater),
+                                                       _mm512_maskz_compress_epi32((__mmask16)~mask, v));
+        _mm512_storeu_si512(arr + left, packedGreater);
+        _mm512_storeu_si512(arr + right - lanes, packedRest);
+        left += greater;
+        right -= lanes - greater;
+    }
+    
+    int pending[3 * 16];
+    size_t count = readRight - readLeft;
+    memcpy(pending, arr + readLeft, count * sizeof(int));
+    _mm512_storeu_si512(pending + count, first);
+    _mm512_storeu_si512(pending + count + lanes, last);
+    return placeRemaining(arr, left, right, pending, count + 2 * lanes, threshold);
+}
+#endif
+
+// Available kernels, fastest last; "auto" picks the best supported one
+enum PartitionKernelType {
+    KERNEL_AUTO,
+    KERNEL_SCALAR,
+    KERNEL_AVX2,
+    KERNEL_AVX512
+};
+
+static const char* const kernelNames[] = {"auto", "scalar", "avx2", "avx512"};
+
+static PartitionKernel partitionKernel = partitionGreaterScalar;
+static enum PartitionKernelType activeKernel = KERNEL_AUTO;   // AUTO = not chosen yet
+
+// Function to check whether the CPU can run a kernel
+int partitionKernelSupported(enum PartitionKernelType type) {
+    switch (type) {
+        case KERNEL_AUTO:
+        case KERNEL_SCALAR:
+            return 1;
+#ifdef HAVE_X86_PARTITION_KERNELS
+        case KERNEL_AVX2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+        case KERNEL_AVX512:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("popcnt");
+#endif
+        default:
+            return 0;
+    }
+}
+
+// Function to select the partition kernel (returns 0 if the CPU lacks it)
+int selectPartitionKernel(enum PartitionKernelType type) {
+    if (type == KERNEL_AUTO) {
+        if (partitionKernelSupported(KERNEL_AVX512)) return selectPartitionKernel(KERNEL_AVX512);
+        if (partitionKernelSupported(KERNEL_AVX2)) return selectPartitionKernel(KERNEL_AVX2);
+        return selectPartitionKernel(KERNEL_SCALAR);
+    }
+    if (!partitionKernelSupported(type)) return 0;
+    
+    switch (type) {
+#ifdef HAVE_X86_PARTITION_KERNELS
+        case KERNEL_AVX2:
+            pthread_once(&compressTableOnce, initCompressTableAVX2);
+            partitionKernel = partitionGreaterAVX2;
+            break;
+        case KERNEL_AVX512:
+            partitionKernel = partitionGreaterAVX512;
+            break;
+#endif
+        default:
+            partitionKernel = partitionGreaterScalar;
+            break;
+    }
+    activeKernel = type;
+    return 1;
+}
+
+static pthread_once_t defaultKernelOnce = PTHREAD_ONCE_INIT;
+
+static void selectDefaultKernel(void) {
+    if (activeKernel == KERNEL_AUTO) selectPartitionKernel(KERNEL_AUTO);
+}
+
+// Function to make sure a partition kernel has been chosen (the best
+// supported one unless --kernel picked another); safe to call from any
+// thread, the choice is made exactly once
+static void ensurePartitionKernel(void) {
+    pthread_once(&defaultKernelOnce, selectDefaultKernel);
+}
+
+// ===================== PRODUCTION SELECTION (INTROSELECT) =====================
+//
+// Iterative introselect for the kth largest element, in place:
+//   - pivot: median of 3 on small ranges, Tukey's ninther on large ones
+//   - partition: the dispatched kernel splits off the keys greater than the
+//     pivot; when that leaves nearly the whole range on the right, a second
+//     pass also splits off the keys equal to the pivot, so duplicate-heavy
+//     ranges always shrink
+//   - guarantee: every three rounds the range must at least halve; if not,
+//     the remaining rounds use median-of-medians pivots, which bounds the
+//     worst case at O(n) (sorted and reverse-sorted inputs included)
+//   - small ranges finish with insertion sort
+// No recursion except inside median-of-medians (depth O(log n)), no output.
+
+#define INTROSELECT_SMALL 16
+#define NINTHER_THRESHOLD 128
+
+// Selection algorithms available behind findKthLargestWith()
+enum SelectAlgorithm {
+    SELECT_QUICKSELECT,      // Demonstration QuickSelect (last-element pivot, traced)
+    SELECT_QUICKSELECT_3WAY, // Demonstration QuickSelect with three-way partition
+    SELECT_INTROSELECT,      // Production introselect (guaranteed O(n), silent)
+    SELECT_FLOYD_RIVEST,     // Sampling-based Floyd-Rivest (reads the input about once)
+    SELECT_PARALLEL          // Multithreaded selection (one thread per CPU, copy mode)
+};
+
+// Function to sort arr[low..high] in descending order
+static void insertionSortDescending(int arr[], int low, int high) {
+    for (int i = low + 1; i <= high; i++) {
+        int key = arr[i];
+        int j = i - 1;
+        while (j >= low && arr[j] < key) {
+            arr[j + 1] = arr[j];
+            j--;
+        }
+        arr[j + 1] = key;
+    }
+}
+
+// Function to return the index of the median of arr[a], arr[b], arr[c]
+static int medianOf3Index(const int arr[], int a, int b, int c) {
+    if (arr[a] < arr[b]) {
+        if (arr[b] < arr[c]) return b;
+        return (arr[a] < arr[c]) ? c : a;
+    }
+    if (arr[a] < arr[c]) return a;
+    return (arr[b] < arr[c]) ? c : b;
+}
+
+// Function to pick Tukey's ninther (median of three medians of three)
+static int nintherIndex(const int arr[], int low, int high) {
+    int step = (high - low) / 8;
+    int mid = low + (high - low) / 2;
+    int m1 = medianOf3Index(arr, low, low + step, low + 2 * step);
+    int m2 = medianOf3Index(arr, mid - step, mid, mid + step);
+    int m3 = medianOf3Index(arr, high - 2 * step, high - step, high);
+    return medianOf3Index(arr, m1, m2, m3);
+}
+
+static void selectPosition(int arr[], int low, int high, int target);
+
+// Function to find a median-of-medians pivot for arr[low..high]
+// Medians of groups of 5 are gathered at the front of the range, then their
+// median is selected in place; it is guaranteed to beat ~30% of the range.
+static int medianOfMediansIndex(int arr[], int low, int high) {
+    int groups = 0;
+    for (int start = low; start <= high; start += 5) {
+        int end = (start + 4 <= high) ? start + 4 : high;
+        insertionSortDescending(arr, start, end);
+        swap(&arr[low + groups], &arr[start + (end - start) / 2]);
+        groups++;
+    }
+    int middle = low + (groups - 1) / 2;
+    selectPosition(arr, low, low + groups - 1, middle);
+    return middle;
+}
+
+// Function to rearrange arr[low..high] so that arr[target] holds the value
+// it would have if the range were sorted in descending order
+static void selectPosition(int arr[], int low, int high, int target) {
+    int useMedianOfMedians = 0;
+    int rounds = 0;
+    int checkpointSize = high - low + 1;
+    
+    while (high - low + 1 > INTROSELECT_SMALL) {
+        int size = high - low + 1;
+        
+        // Every three rounds the range must have halved; otherwise the pivots
+        // are being defeated (adversarial or degenerate input) and we switch
+        if (++rounds % 3 == 1) {
+            if (rounds > 1 && size > checkpointSize / 2) useMedianOfMedians = 1;
+            checkpointSize = size;
+        }
+        
+        int pivotIndex;
+        if (useMedianOfMedians) {
+            pivotIndex = medianOfMediansIndex(arr, low, high);
+        } else if (size > NINTHER_THRESHOLD) {
+            pivotIndex = nintherIndex(arr, low, high);
+        } else {
+            pivotIndex = medianOf3Index(arr, low, low + size / 2, high);
+        }
+        
+        int pivot = arr[pivotIndex];
+        int greaterEnd = low + (int)partitionKernel(arr + low, (size_t)size, pivot);
+        if (target < greaterEnd) {
+            high = greaterEnd - 1;
+            continue;
+        }
+        if (greaterEnd - low >= size / 8) {
+            low = greaterEnd;
+            continue;
+        }
+        
+        // Poor split: peel off the run of keys equal to the pivot (the pivot
+        // itself is among them, so the range always shrinks)
+        int equalEnd = high + 1;
+        if (pivot != INT_MIN) {
+            equalEnd = greaterEnd + (int)partitionKernel(arr + greaterEnd,
+                                                         (size_t)(high - greaterEnd + 1), pivot - 1);
+        }
+        if (target < equalEnd) return;   // Every slot in [greaterEnd, equalEnd) holds the pivot
+        low = equalEnd;
+    }
+    insertionSortDescending(arr, low, high);
+}
+
+// Function to find the kth largest element in place (arr is reordered)
+// Production path: no copy, no output, worst case O(n).
+int selectKthLargest(int arr[], int n, int k) {
+    if (n <= 0 || k < 1 || k > n) return -1;
+    ensurePartitionKernel();
+    selectPosition(arr, 0, n - 1, k - 1);
+    return arr[k - 1];
+}
+
+// ===================== MULTI-RANK SELECTION =====================
+//
+// Several order statistics (e.g. p50/p90/p99/p999) from one partitioning
+// pass: each partition step splits the requested ranks between the two
+// sides and only sides that still hold a requested rank are visited again,
+// so m ranks cost about O(n log m) instead of m separate selections. Each
+// segment uses the introselect pivots and kernel; segments that recurse
+// too deep fall back to one introselect per remaining rank.
+
+#define MULTISELECT_SMALL 32
+
+// Function to select the ascending absolute positions targets[0..count-1]
+// inside arr[low..high] (descending order), storing the values in results
+static void multiSelectRange(int arr[], int low, int high, const int targets[],
+                             int results[], int count, int depthBudget) {
+    while (count > 1 && depthBudget > 0 && high - low + 1 > MULTISELECT_SMALL) {
+        int size = high - low + 1;
+        int pivotIndex = (size > NINTHER_THRESHOLD) ? nintherIndex(arr, low, high)
+                                                    : medianOf3Index(arr, low, low + size / 2, high);
+        int pivot = arr[pivotIndex];
+        int greaterEnd = low + (int)partitionKernel(arr + low, (size_t)size, pivot);
+        int equalEnd = greaterEnd;
+        if (greaterEnd - low < size / 8) {
+            // Poor split: peel off the keys equal to the pivot as well
+            equalEnd = high + 1;
+            if (pivot != INT_MIN) {
+                equalEnd = greaterEnd + (int)partitionKernel(arr + greaterEnd,
+                                                             (size_t)(high - greaterEnd + 1), pivot - 1);
             }
         }
+        
+        int leftCount = 0;
+        while (leftCount < count && targets[leftCount] < greaterEnd) leftCount++;
+        int equalCount = 0;
+        while (leftCount + equalCount < count && targets[leftCount + equalCount] < equalEnd) {
+            results[leftCount + equalCount] = pivot;
+            equalCount++;
+        }
+        
+        depthBudget--;
+        if (leftCount > 0) {
+            multiSelectRange(arr, low, greaterEnd - 1, targets, results, leftCount, depthBudget);
+        }
+        
+        // Continue with the right side in this frame
+        targets += leftCount + equalCount;
+        results += leftCount + equalCount;
+        count -= leftCount + equalCount;
+        low = equalEnd;
     }
     
-    printArray(sortedArr, n, "Sorted array (descending)");
-    printf("The %d%s largest element is: %d\n", 
-           k, (k == 1) ? "st" : (k == 2) ? "nd" : (k == 3) ? "rd" : "th", result);
-    printf("Verification: sortedArr[%d] = %d ✓\n", k-1, sortedArr[k-1]);
+    if (count == 0) return;
+    if (high - low + 1 <= MULTISELECT_SMALL) {
+        insertionSortDescending(arr, low, high);
+        for (int i = 0; i < count; i++) results[i] = arr[targets[i]];
+        return;
+    }
     
-    free(sortedArr);
+    // One rank left (or too deep): select the ranks one after another; each
+    // selection leaves everything after its target <= it, so the next one
+    // only has to look to the right
+    for (int i = 0; i < count; i++) {
+        if (targets[i] >= low) {
+            selectPosition(arr, low, high, targets[i]);
+            low = targets[i] + 1;
+        }
+        results[i] = arr[targets[i]];
+    }
 }
 
-// Function to analyze time complexity
-void analyzeTimeComplexity() {
-    printf("\n=== TIME COMPLEXITY ANALYSIS ===\n");
-    printf("QuickSelect Algorithm:\n");
-    printf("• Best Case: O(n) - When pivot divides array into equal halves\n");
-    printf("• Average Case: O(n) - Expected linear time\n");
-    printf("• Worst Case: O(n²) - When pivot is always the smallest/largest\n");
-    printf("\nRecurrence Relation:\n");
-    printf("• T(n) = T(n/2) + O(n) in average case\n");
-    printf("• T(n) = T(n-1) + O(n) in worst case\n");
-    printf("\nSpace Complexity: O(log n) for recursion stack (average case)\n");
-    printf("\nAdvantage over full sorting:\n");
-    printf("• QuickSelect: O(n) average case\n");
-    printf("• Full QuickSort: O(n log n)\n");
+// Function to find several order statistics at once, in place
+// ranks[] holds m kth-largest ranks (1-based) in ascending order (repeats
+// allowed); results[i] receives the ranks[i]-th largest element.
+// Returns 0 on success, -1 if a rank is out of range or out of order.
+int selectKthLargestMany(int arr[], int n, const int ranks[], int m, int results[]) {
+    if (n <= 0 || m <= 0) return -1;
+    for (int i = 0; i < m; i++) {
+        if (ranks[i] < 1 || ranks[i] > n || (i > 0 && ranks[i] < ranks[i - 1])) return -1;
+    }
+    ensurePartitionKernel();
+    
+    int* targets = (int*)malloc((size_t)m * sizeof(int));
+    for (int i = 0; i < m; i++) targets[i] = ranks[i] - 1;
+    
+    int depthBudget = 2;
+    for (int size = n; size > 1; size /= 2) depthBudget += 2;
+    multiSelectRange(arr, 0, n - 1, targets, results, m, depthBudget);
+    
+    free(targets);
+    return 0;
 }
 
-// Test function with multiple examples
-void runTests() {
-    printf("=== ADDITIONAL TEST CASES ===\n");
+// Function to compute percentiles (nearest-rank definition) in one pass
+// percentiles[] are in ascending order, e.g. {50, 90, 99, 99.9}; arr is
+// left untouched. Returns 0 on success, -1 on invalid input.
+int findPercentiles(const int arr[], int n, const double percentiles[], int m, int results[]) {
+    if (n <= 0 || m <= 0) return -1;
     
-    // Test case 1
-    int test1[] = {3, 2, 1, 5, 6, 4};
-    int n1 = 6, k1 = 2;
-    printf("\nTest 1: ");
-    printArray(test1, n1, "Array");
-    printf("k = %d, Result = %d\n", k1, findKthLargest(test1, n1, k1));
+    // Ascending percentiles are descending kth-largest ranks, so reverse
+    int* ranks = (int*)malloc((size_t)m * sizeof(int));
+    int* values = (int*)malloc((size_t)m * sizeof(int));
+    for (int i = 0; i < m; i++) {
+        double p = percentiles[i];
+        if (p < 0.0 || p > 100.0 || (i > 0 && p < percentiles[i - 1])) {
+            free(ranks);
+            free(values);
+            return -1;
+        }
+        int ascendingRank = (int)ceil(p / 100.0 * n);
+        if (ascendingRank < 1) ascendingRank = 1;
+        ranks[m - 1 - i] = n - ascendingRank + 1;
+    }
     
-    // Test case 2
-    int test2[] = {3, 2, 3, 1, 2, 4, 5, 5, 6};
-    int n2 = 9, k2 = 4;
-    printf("\nTest 2: ");
-    printArray(test2, n2, "Array");
-    printf("k = %d, Result = %d\n", k2, findKthLargest(test2, n2, k2));
+    int* tempArr = (int*)malloc((size_t)n * sizeof(int));
+    memcpy(tempArr, arr, (size_t)n * sizeof(int));
+    int status = selectKthLargestMany(tempArr, n, ranks, m, values);
+    for (int i = 0; status == 0 && i < m; i++) results[i] = values[m - 1 - i];
     
-    // Test case 3
-    int test3[] = {1};
-    int n3 = 1, k3 = 1;
-    printf("\nTest 3: ");
-    printArray(test3, n3, "Array");
-    printf("k = %d, Result = %d\n", k3, findKthLargest(test3, n3, k3));
+    free(tempArr);
+    free(values);
+    free(ranks);
+    return status;
+}
+
+// ===================== FLOYD-RIVEST SELECTION =====================
+//
+// Sampling-based selection that reads the input about once:
+//   1. draw a random sample of s ~ n^(2/3) elements and pick two pivots
+//      u >= v from it whose sample ranks bracket k's expected rank by a
+//      few standard deviations (one multiselect over the sample)
+//   2. one read-only pass over the array counts the elements above u and
+//      copies the band [v, u] (expected size ~ n^(2/3) log^(1/2) n) aside
+//   3. k's rank inside the band is selected recursively (Floyd-Rivest again
+//      while the band is large, introselect once it is small)
+// If the sample predicts a large band (heavy duplicates), the band
+// overflows its budget, or k lands outside it (a low-probability event),
+// the routine falls back to introselect on a copy.
+// The caller's array is never modified.
+
+#define FLOYD_RIVEST_CUTOFF 4096         // Below this, introselect on a copy
+
+// Function to select the kth largest with introselect on a private copy
+static int selectFromCopy(const int arr[], int n, int k) {
+    int* tempArr = (int*)malloc((size_t)n * sizeof(int));
+    memcpy(tempArr, arr, (size_t)n * sizeof(int));
+    int result = selectKthLargest(tempArr, n, k);
+    free(tempArr);
+    return result;
+}
+
+// Function to find the kth largest element with Floyd-Rivest sampling
+int floydRivestSelect(const int arr[], int n, int k) {
+    if (n <= 0 || k < 1 || k > n) return -1;
+    if (n <= FLOYD_RIVEST_CUTOFF) return selectFromCopy(arr, n, k);
+    ensurePartitionKernel();
+    
+    // Sample size and bracket half-width from Floyd and Rivest's analysis
+    double logN = log((double)n);
+    int sampleSize = (int)(0.5 * pow((double)n, 2.0 / 3.0));
+    double gap = sqrt(sampleSize * logN) / 2.0;
+    double center = (double)k * sampleSize / n;
+    int upperRank = (int)(center - gap);
+    int lowerRank = (int)(center + gap);
+    if (upperRank < 1) upperRank = 1;
+    if (lowerRank > sampleSize) lowerRank = sampleSize;
+    if (lowerRank < upperRank) lowerRank = upperRank;
+    
+    int* sample = (int*)malloc((size_t)sampleSize * sizeof(int));
+    unsigned long long seed = 0xF10D5EEDULL ^ (unsigned long long)n ^ ((unsigned long long)k << 32);
+    for (int i = 0; i < sampleSize; i++) {
+        sample[i] = arr[nextRandom(&seed) % (unsigned long long)n];
+    }
+    int ranks[2] = {upperRank, lowerRank};
+    int pivots[2];
+    selectKthLargestMany(sample, sampleSize, ranks, 2, pivots);
+    int upper = pivots[0];   // u: about k - gap*n/s elements are above it
+    int lower = pivots[1];   // v: about k + gap*n/s elements are at or above it
+    
+    // The sample also predicts the band size; runs of duplicates around the
+    // pivots make it large, and then plain introselect is the better tool
+    unsigned width = (unsigned)upper - (unsigned)lower;
+    int sampleBand = 0;
+    for (int i = 0; i < sampleSize; i++) {
+        sampleBand += ((unsigned)sample[i] - (unsigned)lower <= width);
+    }
+    free(sample);
+    if (sampleBand > sampleSize / 4) return selectFromCopy(arr, n, k);
+    
+    // One pass: count the elements above u and keep the band [v, u]. Only a
+    // few percent of the elements fall in the band, so that branch predicts
+    // well; the range test is a single unsigned comparison.
+    size_t expectedBand = (size_t)((double)sampleBand * n / sampleSize);
+    size_t capacity = 2 * expectedBand + 1024;
+    int* band = (int*)malloc(capacity * sizeof(int));
+    size_t above = 0, inBand = 0;
+    int overflow = 0;
+    for (int i = 0; i < n; i++) {
+        int value = arr[i];
+        above += (value > upper);
+        if ((unsigned)value - (unsigned)lower <= width) {
+            if (inBand == capacity) {
+                overflow = 1;              // Far more pivot duplicates than expected
+                break;
+            }
+            band[inBand++] = value;
+        }
+    }
+    
+    int result;
+    if (overflow) {
+        result = selectFromCopy(arr, n, k);          // Band did not shrink (duplicates)
+    } else if ((size_t)k <= above || (size_t)k > above + inBand) {
+        result = selectFromCopy(arr, n, k);          // Unlucky sample
+    } else if (upper == lower) {
+        result = upper;                              // The band is one repeated value
+    } else {
+        result = floydRivestSelect(band, (int)inBand, k - (int)above);
+    }
+    
+    free(band);
+    return result;
+}
+
+// ===================== STREAMING TOP-K =====================
+//
+// Bounded-memory k-th largest / top-k over input that arrives in chunks.
+// Two interchangeable strategies, both O(k) memory:
+//   - heap: a k-element min-heap whose root is the current k-th largest;
+//     each new value costs one comparison, or O(log k) when it enters
+//   - buffer: a 2k-element buffer plus a threshold (the k-th largest at the
+//     last compaction). Values at or below the threshold are dropped with
+//     one comparison; when the buffer fills, the production selection
+//     keeps its k largest, so the amortized cost per value is O(1)
+
+// Strategy used by a TopKStream
+enum TopKMode {
+    TOPK_HEAP,
+    TOPK_BUFFER
+};
+
+struct TopKStream {
+    int k;
+    enum TopKMode mode;
+    int* items;              // Heap (k slots) or buffer (2k slots)
+    int count;               // Items currently held
+    int threshold;           // Buffer mode: k-th largest at the last compaction
+    int hasThreshold;
+    long long seen;          // Values pushed so far
+};
+
+// Function to create a stream that tracks the k largest values seen
+struct TopKStream* createTopKStream(int k, enum TopKMode mode) {
+    if (k < 1) return NULL;
+    struct TopKStream* stream = (struct TopKStream*)malloc(sizeof(struct TopKStream));
+    stream->k = k;
+    stream->mode = mode;
+    stream->items = (int*)malloc((size_t)k * (mode == TOPK_BUFFER ? 2 : 1) * sizeof(int));
+    stream->count = 0;
+    stream->threshold = 0;
+    stream->hasThreshold = 0;
+    stream->seen = 0;
+    return stream;
+}
+
+// Function to restore the min-heap property below index i
+static void siftDownMin(int heap[], int count, int i) {
+    int value = heap[i];
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= count) break;
+        if (child + 1 < count && heap[child + 1] < heap[child]) child++;
+        if (heap[child] >= value) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = value;
+}
+
+// Function to shrink the buffer to its k largest values
+static void compactTopKBuffer(struct TopKStream* stream) {
+    if (stream->count < stream->k || (stream->count == stream->k && stream->hasThreshold)) return;
+    stream->threshold = selectKthLargest(stream->items, stream->count, stream->k);
+    stream->hasThreshold = 1;
+    stream->count = stream->k;
+}
+
+// Function to feed a chunk of values into the stream
+void topKPush(struct TopKStream* stream, const int values[], size_t count) {
+    int k = stream->k;
+    int* items = stream->items;
+    
+    if (stream->mode == TOPK_HEAP) {
+        for (size_t i = 0; i < count; i++) {
+            int value = values[i];
+            if (stream->count < k) {
+                // Sift up while filling
+                int j = stream->count++;
+                while (j > 0 && items[(j - 1) / 2] > value) {
+                    items[j] = items[(j - 1) / 2];
+                    j = (j - 1) / 2;
+                }
+                items[j] = value;
+            } else if (value > items[0]) {
+                items[0] = value;
+                siftDownMin(items, k, 0);
+            }
+        }
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            int value = values[i];
+            if (stream->hasThreshold && value <= stream->threshold) continue;
+            items[stream->count++] = value;
+            if (stream->count == 2 * k) compactTopKBuffer(stream);
+        }
+    }
+    stream->seen += (long long)count;
+}
+
+// Function to get the current k-th largest value
+// Returns 0 and sets *value, or -1 if fewer than k values have been seen.
+int topKCurrent(struct TopKStream* stream, int* value) {
+    if (stream->seen < stream->k) return -1;
+    if (stream->mode == TOPK_HEAP) {
+        *value = stream->items[0];
+    } else {
+        compactTopKBuffer(stream);
+        *value = stream->threshold;
+    }
+    return 0;
+}
+
+// Comparison function for qsort (descending)
+static int compareDescending(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x < y) - (x > y);
+}
+
+// Function to copy the current top-k into out[] in descending order
+// Returns how many values were written (fewer than k early in the stream).
+int topKSnapshot(struct TopKStream* stream, int out[]) {
+    if (stream->mode == TOPK_BUFFER) compactTopKBuffer(stream);
+    int count = stream->count;
+    memcpy(out, stream->items, (size_t)count * sizeof(int));
+    qsort(out, (size_t)count, sizeof(int), compareDescending);
+    return count;
+}
+
+// Function to free a stream
+void freeTopKStream(struct TopKStream* stream) {
+    if (stream == NULL) return;
+    free(stream->items);
+    free(stream);
 }
 
-int main() {
+// ===================== PARALLEL SELECTION =====================
+//
+// Multithreaded selection for arrays that span many cores. Each round:
+//   1. a pivot is drawn from a sample of the current range, at the sample
+//      rank matching k (nudged towards the middle so k lands in the smaller
+//      bucket with high probability)
+//   2. every thread classifies its chunk against that shared pivot into
+//      greater / equal / smaller and reports its counts
+//   3. the counts are prefix-summed; if k falls in the equal run the pivot
+//      is the answer, otherwise only the bucket holding k is gathered into
+//      a contiguous range for the next round
+// Once the range is small it is finished by the sequential introselect,
+// which takes int sizes, so ranges above INT_MAX always get rounds first
+// (inline on one thread if need be).
+//
+// Two storage modes:
+//   - copy (default): arr is never written. Round 1 reads arr directly and
+//     scatters just the surviving bucket into scratch, so no defensive copy
+//     of the whole array is made; later rounds work in place on that scratch.
+//     When no round runs (one thread, or n <= PARALLEL_SELECT_CUTOFF) the
+//     sequential finish still copies all n values into scratch
+//   - in place: threads partition their chunks of arr with the partition
+//     kernel and the bucket is compacted with ordered memmoves; no extra
+//     memory, but arr is left holding an unspecified mix of its values
+
+#define PARALLEL_SELECT_CUTOFF (1 << 18)   // Ranges this small finish sequentially
+#define PARALLEL_SAMPLE_SIZE 1024
+#define SCATTER_BUFFER 1024
+
+// Options for parallelSelectKthLargest()
+struct ParallelSelectOptions {
+    int numThreads;     // Worker threads (0 = one per CPU)
+    int inPlace;        // 1 = reorder arr and skip the scratch buffers
+};
+
+// Buckets of one parallel round
+enum SelectBucket {
+    BUCKET_GREATER,
+    BUCKET_EQUAL,
+    BUCKET_SMALLER
+};
+
+// Shared state of one round of parallel selection
+struct ParallelSelectRound {
+    const int* src;          // Current range (read)
+    int* data;               // Current range (in-place mode: same as src)
+    int* dst;                // Copy mode: where the surviving bucket goes
+    size_t size;
+    int pivot;
+    enum SelectBucket bucket;
+    size_t* greater;         // Per-thread counts
+    size_t* equal;
+    size_t* offsets;         // Per-thread write offsets into dst
+};
+
+// Function to count, per chunk, the elements greater than and equal to the pivot
+static void countAroundPivotTask(int threadId, int numThreads, void* arg) {
+    struct ParallelSelectRound* round = (struct ParallelSelectRound*)arg;
+    size_t begin, end;
+    chunkRange(round->size, threadId, numThreads, &begin, &end);
+    
+    const int* src = round->src;
+    int pivot = round->pivot;
+    size_t greater = 0, equal = 0;
+    for (size_t i = begin; i < end; i++) {
+        greater += (src[i] > pivot);
+        equal += (src[i] == pivot);
+    }
+    round->greater[threadId] = greater;
+    round->equal[threadId] = equal;
+}
+
+// Function to copy the chunk's elements of the chosen bucket to dst
+// Elements are compacted branch-free into a small local buffer first, so no
+// thread ever writes past its own slice of dst.
+static void scatterBucketTask(int threadId, int numThreads, void* arg) {
+    struct ParallelSelectRound* round = (struct ParallelSelectRound*)arg;
+    size_t begin, end;
+    chunkRange(round->size, threadId, numThreads, &begin, &end);
+    
+    const int* src = round->src;
+    int* out = round->dst + round->offsets[threadId];
+    int pivot = round->pivot;
+    int wantGreater = (round->bucket == BUCKET_GREATER);
+    int buffer[SCATTER_BUFFER];
+    int buffered = 0;
+    
+    for (size_t i = begin; i < end; i++) {
+        int value = src[i];
+        buffer[buffered] = value;
+        buffered += wantGreater ? (value > pivot) : (value < pivot);
+        if (buffered == SCATTER_BUFFER) {
+            memcpy(out, buffer, sizeof(buffer));
+            out += SCATTER_BUFFER;
+            buffered = 0;
+        }
+    }
+    memcpy(out, buffer, (size_t)buffered * sizeof(int));
+}
+
+// Function to split each chunk in place into [greater | rest]
+static void partitionGreaterTask(int threadId, int numThreads, void* arg) {
+    struct ParallelSelectRound* round = (struct ParallelSelectRound*)arg;
+    size_t begin, end;
+    chunkRange(round->size, threadId, numThreads, &begin, &end);
+    round->greater[threadId] = partitionKernel(round->data + begin, end - begin, round->pivot);
+}
+
+// Function to split the rest of each chunk in place into [equal | smaller]
+static void partitionEqualTask(int threadId, int numThreads, void* arg) {
+    struct ParallelSelectRound* round = (struct ParallelSelectRound*)arg;
+    size_t begin, end;
+    chunkRange(round->size, threadId, numThreads, &begin, &end);
+    begin += round->greater[threadId];
+    
+    if (round->pivot == INT_MIN) {
+        round->equal[threadId] = end - begin;   // Nothing is smaller than INT_MIN
+    } else {
+        round->equal[threadId] = partitionKernel(round->data + begin, end - begin, round->pivot - 1);
+    }
+}
+
+// Function to draw a pivot for rank k (1-based, largest first) of range[0..size)
+static int sampleRankPivot(const int* range, size_t size, size_t k, unsigned long long* seed) {
+    int sample[PARALLEL_SAMPLE_SIZE];
+    for (int i = 0; i < PARALLEL_SAMPLE_SIZE; i++) {
+        sample[i] = range[nextRandom(seed) % size];
+    }
+    
+    // Aim a few standard deviations past k's estimated sample rank, towards
+    // the middle, so k usually ends up in the smaller bucket
+    double q = (double)(k - 1) / (double)size;
+    double slack = 3.0 * sqrt(PARALLEL_SAMPLE_SIZE * q * (1.0 - q)) + 1.0;
+    double rank = q * PARALLEL_SAMPLE_SIZE + (q <= 0.5 ? slack : -slack);
+    if (rank < 0.0) rank = 0.0;
+    if (rank > PARALLEL_SAMPLE_SIZE - 1) rank = PARALLEL_SAMPLE_SIZE - 1;
+    
+    return selectKthLargest(sample, PARALLEL_SAMPLE_SIZE, (int)rank + 1);
+}
+
+// Function to find the kth largest element using several threads
+// k is 1-based. In copy mode arr is only read; in place it is clobbered.
+// Copy mode with one thread (or n <= PARALLEL_SELECT_CUTOFF) still copies
+// the full array before the sequential finish, unless n > INT_MAX.
+int parallelSelectKthLargest(int arr[], size_t n, size_t k, const struct ParallelSelectOptions* options) {
+    if (n == 0 || k < 1 || k > n) return -1;
+    ensurePartitionKernel();
+    
+    int threads = (options && options->numThreads > 0) ? options->numThreads : defaultThreadCount();
+    int inPlace = options ? options->inPlace : 0;
+    
+    size_t* counters = (size_t*)malloc(3 * (size_t)threads * sizeof(size_t));
+    struct ParallelSelectRound round;
+    round.greater = counters;
+    round.equal = counters + threads;
+    round.offsets = counters + 2 * (size_t)threads;
+    
+    int* current = arr;          // Start of the current range
+    size_t size = n;
+    int* scratch = NULL;         // Copy mode: owns the range after round 1
+    unsigned long long seed = 0x5EEDULL ^ n;
+    int result = 0, found = 0;
+    
+    while (!found && size > PARALLEL_SELECT_CUTOFF && (threads > 1 || size > (size_t)INT_MAX)) {
+        round.src = current;
+        round.data = current;
+        round.size = size;
+        round.pivot = sampleRankPivot(current, size, k, &seed);
+        
+        size_t greater = 0, equal = 0;
+        int writable = inPlace || current == scratch;
+        if (writable) {
+            runParallel(threads, partitionGreaterTask, &round);
+            for (int t = 0; t < threads; t++) greater += round.greater[t];
+            if (k > greater) {
+                runParallel(threads, partitionEqualTask, &round);
+                for (int t = 0; t < threads; t++) equal += round.equal[t];
+            }
+        } else {
+            runParallel(threads, countAroundPivotTask, &round);
+            for (int t = 0; t < threads; t++) {
+                greater += round.greater[t];
+                equal += round.equal[t];
+            }
+        }
+        
+        if (k <= greater) {
+            round.bucket = BUCKET_GREATER;
+        } else if (k <= greater + equal) {
+            result = round.pivot;
+            found = 1;
+            break;
+        } else {
+            round.bucket = BUCKET_SMALLER;
+            k -= greater + equal;
+        }
+        size_t bucketSize = (round.bucket == BUCKET_GREATER) ? greater : size - greater - equal;
+        
+        if (writable) {
+            // Ordered memmove: each chunk's slice lands at or before its
+            // source, so slices not yet moved are never overwritten
+            size_t out = 0;
+            for (int t = 0; t < threads; t++) {
+                size_t begin, end;
+                chunkRange(size, t, threads, &begin, &end);
+                size_t skip = 0, length = round.greater[t];
+                if (round.bucket == BUCKET_SMALLER) {
+                    skip = round.greater[t] + round.equal[t];
+                    length = (end - begin) - skip;
+                }
+                memmove(current + out, current + begin + skip, length * sizeof(int));
+                out += length;
+            }
+        } else {
+            scratch = (int*)malloc((bucketSize ? bucketSize : 1) * sizeof(int));
+            round.dst = scratch;
+            size_t offset = 0;
+            for (int t = 0; t < threads; t++) {
+                round.offsets[t] = offset;
+                size_t begin, end;
+                chunkRange(size, t, threads, &begin, &end);
+                offset += (round.bucket == BUCKET_GREATER) ? round.greater[t]
+                                                           : (end - begin) - round.greater[t] - round.equal[t];
+            }
+            runParallel(threads, scatterBucketTask, &round);
+            current = scratch;
+        }
+        size = bucketSize;
+    }
+    
+    if (!found) {
+        // Finish sequentially; in copy mode the range must not still be arr
+        if (!inPlace && current == arr) {
+            scratch = (int*)malloc(size * sizeof(int));
+            memcpy(scratch, arr, size * sizeof(int));
+            current = scratch;
+        }
+        result = selectKthLargest(current, (int)size, (int)k);
+    }
+    
+    free(scratch);
+    free(counters);
+    return result;
+}
+
+// ===================== KLL QUANTILE SKETCH =====================
+//
+// Approximate order statistics in bounded memory (Karnin-Lang-Liberty).
+// The sketch is a stack of compactors; an item on level h stands for 2^h
+// input values. When the sketch outgrows its budget, the lowest full level
+// is sorted and every other item (random offset) is promoted one level up.
+// Capacities shrink geometrically (factor 2/3) from the top level down, so
+// memory is about 3k items while the normalized rank error is about 1.65/k.
+// Sketches built on different threads or processes merge level by level,
+// with the same error guarantee as a sketch built over all the data.
+
+#define KLL_SHRINK (2.0 / 3.0)
+#define KLL_MIN_CAPACITY 8            // Keeps the lowest levels from compacting every item
+#define KLL_MIN_K 8
+#define KLL_MAX_K (1 << 24)           // Keeps the summed level capacities within int
+#define KLL_MAX_LEVELS 64
+#define KLL_ERROR_CONSTANT 1.65
+
+struct KLLLevel {
+    int* items;
+    int count;
+    int allocated;
+    int capacity;                // Compaction threshold (recomputed as levels are added)
+};
+
+struct KLLSketch {
+    int k;                       // Capacity of the top level
+    int numLevels;
+    struct KLLLevel* levels;     // levels[0] holds raw values
+    int size;                    // Items held over all levels
+    int maxSize;                 // Sum of the level capacities
+    long long n;                 // Values summarized
+    unsigned long long seed;     // Coin flips for compaction offsets
+};
+
+// Function to pick k for a target normalized rank error (e.g. 0.01 = 1%)
+int kllParameterForError(double epsilon) {
+    if (epsilon <= 0.0) epsilon = 0.01;
+    double k = ceil(KLL_ERROR_CONSTANT / epsilon);
+    if (k > KLL_MAX_K) return KLL_MAX_K;
+    return k < KLL_MIN_K ? KLL_MIN_K : (int)k;
+}
+
+
+// Function to add an empty level on top (capacities below shrink)
+static void kllGrow(struct KLLSketch* sketch) {
+    sketch->levels = (struct KLLLevel*)realloc(sketch->levels,
+                                               (size_t)(sketch->numLevels + 1) * sizeof(struct KLLLevel));
+    struct KLLLevel* level = &sketch->levels[sketch->numLevels];
+    level->items = NULL;
+    level->count = 0;
+    level->allocated = 0;
+    sketch->numLevels++;
+    
+    // Capacities shrink by KLL_SHRINK per level below the top
+    sketch->maxSize = 0;
+    for (int h = 0; h < sketch->numLevels; h++) {
+        int depth = sketch->numLevels - h - 1;
+        int capacity = (int)ceil(sketch->k * pow(KLL_SHRINK, depth));
+        if (capacity < KLL_MIN_CAPACITY) capacity = KLL_MIN_CAPACITY;
+        sketch->levels[h].capacity = capacity;
+        sketch->maxSize += capacity;
+    }
+}
+
+// Function to append items to a level
+static void kllAppend(struct KLLLevel* level, const int items[], int count) {
+    if (count == 0) return;
+    if (level->count + count > level->allocated) {
+        int allocated = level->allocated ? level->allocated : 16;
+        while (allocated < level->count + count) allocated *= 2;
+        level->items = (int*)realloc(level->items, (size_t)allocated * sizeof(int));
+        level->allocated = allocated;
+    }
+    memcpy(level->items + level->count, items, (size_t)count * sizeof(int));
+    level->count += count;
+}
+
+// Comparison function for qsort (ascending)
+static int compareAscending(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// Function to compact level h: half of its items move up one level
+static void kllCompactLevel(struct KLLSketch* sketch, int h) {
+    if (h + 1 >= sketch->numLevels) kllGrow(sketch);
+    struct KLLLevel* level = &sketch->levels[h];
+    struct KLLLevel* above = &sketch->levels[h + 1];
+    
+    // Either sort direction works; the low levels are short and compacted
+    // constantly, so they skip the qsort call overhead
+    if (level->count <= 64) {
+        insertionSortDescending(level->items, 0, level->count - 1);
+    } else {
+        qsort(level->items, (size_t)level->count, sizeof(int), compareAscending);
+    }
+    
+    // An odd item out (the first) stays behind so total weight is
+    // preserved exactly; of each remaining pair one item, chosen by a
+    // shared coin flip, is promoted
+    int keep = level->count % 2;
+    int pairs = level->count / 2;
+    int offset = (int)(nextRandom(&sketch->seed) & 1);
+    int leftover = level->items[0];
+    for (int i = 0; i < pairs; i++) {
+        level->items[i] = level->items[keep + 2 * i + offset];
+    }
+    kllAppend(above, level->items, pairs);
+    if (keep) level->items[0] = leftover;
+    
+    sketch->size -= level->count - keep - pairs;
+    level->count = keep;
+}
+
+// Function to compact levels until the sketch fits its budget again
+static void kllCompress(struct KLLSketch* sketch) {
+    while (sketch->size >= sketch->maxSize) {
+        for (int h = 0; h < sketch->numLevels; h++) {
+            if (sketch->levels[h].count >= sketch->levels[h].capacity) {
+                kllCompactLevel(sketch, h);
+                break;
+            }
+        }
+    }
+}
+
+// Function to create an empty sketch; k trades memory for accuracy
+// k is clamped to [KLL_MIN_K, KLL_MAX_K].
+struct KLLSketch* kllCreate(int k, unsigned long long seed) {
+    struct KLLSketch* sketch = (struct KLLSketch*)malloc(sizeof(struct KLLSketch));
+    if (k < KLL_MIN_K) k = KLL_MIN_K;
+    if (k > KLL_MAX_K) k = KLL_MAX_K;
+    sketch->k = k;
+    sketch->numLevels = 0;
+    sketch->levels = NULL;
+    sketch->size = 0;
+    sketch->maxSize = 0;
+    sketch->n = 0;
+    sketch->seed = seed;
+    kllGrow(sketch);
+    return sketch;
+}
+
+// Function to free a sketch
+void kllFree(struct KLLSketch* sketch) {
+    if (sketch == NULL) return;
+    for (int h = 0; h < sketch->numLevels; h++) {
+        free(sketch->levels[h].items);
+    }
+    free(sketch->levels);
+    free(sketch);
+}
+
+// Function to add values to a sketch
+// Values go to level 0 in runs that fill the remaining budget; the sketch
+// is compressed whenever the budget is reached.
+void kllUpdate(struct KLLSketch* sketch, const int values[], size_t count) {
+    size_t done = 0;
+    while (done < count) {
+        size_t room = (size_t)(sketch->maxSize - sketch->size);
+        size_t take = (count - done < room) ? count - done : room;
+        kllAppend(&sketch->levels[0], values + done, (int)take);
+        sketch->size += (int)take;
+        done += take;
+        if (sketch->size >= sketch->maxSize) kllCompress(sketch);
+    }
+    sketch->n += (long long)count;
+}
+
+// Function to merge src into dst (src is unchanged)
+// Returns -1 if the sketches were built with different k.
+int kllMerge(struct KLLSketch* dst, const struct KLLSketch* src) {
+    if (dst->k != src->k) return -1;
+    while (dst->numLevels < src->numLevels) kllGrow(dst);
+    for (int h = 0; h < src->numLevels; h++) {
+        kllAppend(&dst->levels[h], src->levels[h].items, src->levels[h].count);
+        dst->size += src->levels[h].count;
+    }
+    dst->n += src->n;
+    kllCompress(dst);
+    return 0;
+}
+
+// Weighted item used by queries
+struct KLLWeighted {
+    int value;
+    long long weight;
+};
+
+static int compareWeightedDescending(const void* a, const void* b) {
+    int x = ((const struct KLLWeighted*)a)->value;
+    int y = ((const struct KLLWeighted*)b)->value;
+    return (x < y) - (x > y);
+}
+
+// Function to estimate the kth largest value summarized by the sketch
+// Returns 0 and sets *value, or -1 if rank is out of range.
+int kllKthLargest(const struct KLLSketch* sketch, long long rank, int* value) {
+    if (rank < 1 || rank > sketch->n) return -1;
+    
+    struct KLLWeighted* items = (struct KLLWeighted*)malloc((size_t)sketch->size * sizeof(struct KLLWeighted));
+    int count = 0;
+    for (int h = 0; h < sketch->numLevels; h++) {
+        for (int i = 0; i < sketch->levels[h].count; i++) {
+            items[count].value = sketch->levels[h].items[i];
+            items[count].weight = 1LL << h;
+            count++;
+        }
+    }
+    qsort(items, (size_t)count, sizeof(struct KLLWeighted), compareWeightedDescending);
+    
+    long long cumulative = 0;
+    *value = items[count - 1].value;
+    for (int i = 0; i < count; i++) {
+        cumulative += items[i].weight;
+        if (cumulative >= rank) {
+            *value = items[i].value;
+            break;
+        }
+    }
+    free(items);
+    return 0;
+}
+
+// Function to estimate how many summarized values are >= value
+long long kllCountAtLeast(const struct KLLSketch* sketch, int value) {
+    long long count = 0;
+    for (int h = 0; h < sketch->numLevels; h++) {
+        for (int i = 0; i < sketch->levels[h].count; i++) {
+            if (sketch->levels[h].items[i] >= value) count += 1LL << h;
+        }
+    }
+    return count;
+}
+
+// File layout of a saved sketch (lets separate processes merge results)
+struct KLLFileHeader {
+    char magic[8];           // "KLLSKCH"
+    int32_t k;
+    int32_t numLevels;
+    int64_t n;
+};
+
+// Function to write a sketch to a binary file; returns 0 on success
+int kllSave(const struct KLLSketch* sketch, const char* path) {
+    FILE* fp = fopen(path, "wb");
+    if (!fp) return -1;
+    struct KLLFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "KLLSKCH", 8);
+    header.k = sketch->k;
+    header.numLevels = sketch->numLevels;
+    header.n = sketch->n;
+    
+    int ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+    for (int h = 0; ok && h < sketch->numLevels; h++) {
+        int32_t count = sketch->levels[h].count;
+        ok = fwrite(&count, sizeof(count), 1, fp) == 1 &&
+             (count == 0 || fwrite(sketch->levels[h].items, sizeof(int), (size_t)count, fp) == (size_t)count);
+    }
+    if (fclose(fp) != 0) ok = 0;
+    return ok ? 0 : -1;
+}
+
+// Function to read a sketch written by kllSave(); NULL on error
+// Truncated or inconsistent files are rejected rather than partly loaded:
+// k and numLevels must be values kllCreate/kllGrow can produce, the level
+// counts must fit the budget (a saved sketch always holds fewer than
+// maxSize items), and the level weights must add up to n.
+struct KLLSketch* kllLoad(const char* path) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return NULL;
+    struct KLLFileHeader header;
+    if (fread(&header, sizeof(header), 1, fp) != 1 || memcmp(header.magic, "KLLSKCH", 8) != 0 ||
+        header.k < KLL_MIN_K || header.k > KLL_MAX_K ||
+        header.numLevels < 1 || header.numLevels > KLL_MAX_LEVELS || header.n < 0) {
+        fclose(fp);
+        return NULL;
+    }
+    
+    struct KLLSketch* sketch = kllCreate(header.k, (unsigned long long)header.n);
+    while (sketch->numLevels < header.numLevels) kllGrow(sketch);
+    unsigned long long weight = 0;
+    int ok = 1;
+    for (int h = 0; ok && h < header.numLevels; h++) {
+        int32_t count;
+        if (fread(&count, sizeof(count), 1, fp) != 1 || count < 0 ||
+            count >= sketch->maxSize - sketch->size) {
+            ok = 0;
+            break;
+        }
+        int* items = (int*)malloc((size_t)(count ? count : 1) * sizeof(int));
+        if (fread(items, sizeof(int), (size_t)count, fp) == (size_t)count) {
+            kllAppend(&sketch->levels[h], items, count);
+            sketch->size += count;
+            weight += (unsigned long long)count << h;
+        } else {
+            ok = 0;
+        }
+        free(items);
+    }
+    fclose(fp);
+    if (!ok || weight != (unsigned long long)header.n) {
+        kllFree(sketch);
+        return NULL;
+    }
+    sketch->n = header.n;
+    return sketch;
+}
+
+// ===================== TYPE-SPECIALIZED SELECTION =====================
+//
+// DEFINE_SELECTION stamps out a selection routine for one element type, the
+// way a C++ template would: the key projection and the ordering are macros,
+// so every comparison is inlined into the generated code (no qsort-style
+// function pointer per comparison).
+//
+//   NAME     prefix of the generated functions
+//   TYPE     element type (a scalar or a record)
+//   KEY_TYPE type of the projected key
+//   KEY(x)   projection from an element to its key
+//   BEFORE(a, b)  strict ordering on keys: nonzero if a ranks ahead of b
+//                 (SELECT_GREATER gives kth largest, SELECT_LESS kth smallest)
+//
+// It generates:
+//   size_t NAMEInPlace(TYPE arr[], size_t n, size_t k)
+//       reorders arr so the kth ranked element sits at index k - 1, with
+//       every element ranked ahead of it before that index; returns k - 1
+//   size_t NAMEIndex(const TYPE arr[], size_t n, size_t k)
+//       leaves arr untouched and returns the index of the kth ranked
+//       element; only (key, index) pairs are moved, never the payloads
+// Both return SELECT_NOT_FOUND if k is outside 1..n (or out of memory).
+
+#define SELECT_NOT_FOUND ((size_t)-1)
+#define SELECT_SMALL 16
+
+// Orderings for BEFORE
+#define SELECT_GREATER(a, b) ((a) > (b))
+#define SELECT_LESS(a, b) ((a) < (b))
+// Floating point, largest first, with NaNs ranked after every number
+#define SELECT_GREATER_NAN_LAST(a, b) ((a) > (b) || ((b) != (b) && (a) == (a)))
+
+// Projections for KEY
+#define SELECT_IDENTITY(x) (x)
+#define SELECT_ENTRY_KEY(x) ((x).key)
+
+// Core routines over TYPE[low..high]; shared by both generated entry points
+#define DEFINE_SELECTION_CORE(NAME, TYPE, KEY_TYPE, KEY, BEFORE)                              \
+    static inline void NAME##Swap(TYPE* a, TYPE* b) {                                         \
+        TYPE temp = *a;                                                                       \
+        *a = *b;                                                                              \
+        *b = temp;                                                                            \
+    }                                                                                         \
+                                                                                              \
+    static void NAME##InsertionSort(TYPE* arr, size_t low, size_t high) {                     \
+        for (size_t i = low + 1; i <= high; i++) {                                            \
+            TYPE value = arr[i];                                                              \
+            size_t j = i;                                                                     \
+            while (j > low && BEFORE(KEY(value), KEY(arr[j - 1]))) {                          \
+                arr[j] = arr[j - 1];                                                          \
+                j--;                                                                          \
+            }                                                                                 \
+            arr[j] = value;                                                                   \
+        }                                                                                     \
+    }                                                                                         \
+                                                                                              \
+    /* Heapsort of arr[low..high]: the fallback when pivots keep failing */                   \
+    static void NAME##SiftDown(TYPE* arr, size_t low, size_t root, size_t count) {            \
+        for (;;) {                                                                            \
+            size_t child = 2 * root + 1;                                                      \
+            if (child >= count) return;                                                       \
+            if (child + 1 < count && BEFORE(KEY(arr[low + child]), KEY(arr[low + child + 1])))\
+                child++;                                                                      \
+            if (!BEFORE(KEY(arr[low + root]), KEY(arr[low + child]))) return;                 \
+            NAME##Swap(&arr[low + root], &arr[low + child]);                                  \
+            root = child;                                                                     \
+        }                                                                                     \
+    }                                                                                         \
+                                                                                              \
+    static void NAME##HeapSort(TYPE* arr, size_t low, size_t high) {                          \
+        size_t count = high - low + 1;                                                        \
+        for (size_t i = count / 2; i-- > 0;) NAME##SiftDown(arr, low, i, count);              \
+        while (count > 1) {                                                                   \
+            count--;                                                                          \
+            NAME##Swap(&arr[low], &arr[low + count]);                                         \
+            NAME##SiftDown(arr, low, 0, count);                                               \
+        }                                                                                     \
+    }                                                                                         \
+                                                                                              \
+    /* Index of the median of arr[a], arr[b], arr[c] under BEFORE */                          \
+    static inline size_t NAME##Median3(const TYPE* arr, size_t a, size_t b, size_t c) {       \
+        if (BEFORE(KEY(arr[b]), KEY(arr[a]))) { size_t t = a; a = b; b = t; }                 \
+        if (BEFORE(KEY(arr[c]), KEY(arr[b]))) {                                               \
+            b = c;                                                                            \
+            if (BEFORE(KEY(arr[b]), KEY(arr[a]))) b = a;                                      \
+        }                                                                                     \
+        return b;                                                                             \
+    }                                                                                         \
+                                                                                              \
+    /* Hoare partition around arr[low]; scans stop on equal keys so runs of  */              \
+    /* duplicates split evenly, and both scans are bounded so an inconsistent */             \
+    /* ordering (e.g. NaN with SELECT_GREATER) cannot run off the range      */              \
+    static size_t NAME##Partition(TYPE* arr, size_t low, size_t high) {                       \
+        KEY_TYPE pivot = KEY(arr[low]);                                                       \
+        size_t i = low + 1, j = high;                                                         \
+        for (;;) {                                                                            \
+            while (i <= j && BEFORE(KEY(arr[i]), pivot)) i++;                                 \
+            while (i <= j && BEFORE(pivot, KEY(arr[j]))) j--;                                 \
+            if (i >= j) break;                                                                \
+            NAME##Swap(&arr[i], &arr[j]);                                                     \
+            i++;                                                                              \
+            j--;                                                                              \
+        }                                                                                     \
+        NAME##Swap(&arr[low], &arr[j]);                                                       \
+        return j;                                                                             \
+    }                                                                                         \
+                                                                                              \
+    /* Introselect: median-of-3 (ninther on large ranges) pivots, heapsort */                \
+    /* once the depth budget of 2 log2(n) rounds is spent                  */                \
+    static void NAME##SelectRange(TYPE* arr, size_t low, size_t high, size_t target) {        \
+        int depth = 0;                                                                        \
+        for (size_t size = high - low + 1; size > 1; size >>= 1) depth += 2;                  \
+        while (high - low + 1 > SELECT_SMALL) {                                               \
+            if (depth-- == 0) {                                                               \
+                NAME##HeapSort(arr, low, high);                                               \
+                return;                                                                       \
+            }                                                                                 \
+            size_t size = high - low + 1, mid = low + size / 2, pivot;                        \
+            if (size >= NINTHER_THRESHOLD) {                                                  \
+                size_t step = size / 8;                                                       \
+                pivot = NAME##Median3(arr,                                                    \
+                    NAME##Median3(arr, low, low + step, low + 2 * step),                      \
+                    NAME##Median3(arr, mid - step, mid, mid + step),                          \
+                    NAME##Median3(arr, high - 2 * step, high - step, high));                  \
+            } else {                                                                          \
+                pivot = NAME##Median3(arr, low, mid, high);                                   \
+            }                                                                                 \
+            NAME##Swap(&arr[low], &arr[pivot]);                                               \
+            size_t position = NAME##Partition(arr, low, high);                                \
+            if (position == target) return;                                                   \
+            if (target < position) high = position - 1;                                       \
+            else low = position + 1;                                                          \
+        }                                                                                     \
+        NAME##InsertionSort(arr, low, high);                                                  \
+    }
+
+#define DEFINE_SELECTION(NAME, TYPE, KEY_TYPE, KEY, BEFORE)                                   \
+    DEFINE_SELECTION_CORE(NAME##Core, TYPE, KEY_TYPE, KEY, BEFORE)                            \
+                                                                                              \
+    struct NAME##Entry {                                                                      \
+        KEY_TYPE key;                                                                         \
+        size_t index;                                                                         \
+    };                                                                                        \
+    DEFINE_SELECTION_CORE(NAME##Entries, struct NAME##Entry, KEY_TYPE, SELECT_ENTRY_KEY, BEFORE) \
+                                                                                              \
+    size_t NAME##InPlace(TYPE arr[], size_t n, size_t k) {                                    \
+        if (k < 1 || k > n) return SELECT_NOT_FOUND;                                          \
+        NAME##CoreSelectRange(arr, 0, n - 1, k - 1);                                          \
+        return k - 1;                                                                         \
+    }                                                                                         \
+                                                                                              \
+    size_t NAME##Index(const TYPE arr[], size_t n, size_t k) {                                \
+        if (k < 1 || k > n) return SELECT_NOT_FOUND;                                          \
+        struct NAME##Entry* entries = (struct NAME##Entry*)malloc(n * sizeof(*entries));      \
+        if (entries == NULL) return SELECT_NOT_FOUND;                                         \
+        for (size_t i = 0; i < n; i++) {                                                      \
+            entries[i].key = KEY(arr[i]);                                                     \
+            entries[i].index = i;                                                             \
+        }                                                                                     \
+        NAME##EntriesSelectRange(entries, 0, n - 1, k - 1);                                   \
+        size_t index = entries[k - 1].index;                                                  \
+        free(entries);                                                                        \
+        return index;                                                                         \
+    }
+
+// A request latency sample: selection ranks by latency and reports which
+// request it was without copying the record
+struct LatencyRecord {
+    double latencyMs;
+    uint64_t requestId;
+};
+
+#define LATENCY_KEY(record) ((record).latencyMs)
+
+// Kth largest for the common element types
+DEFINE_SELECTION(selectInt64, int64_t, int64_t, SELECT_IDENTITY, SELECT_GREATER)
+DEFINE_SELECTION(selectFloat, float, float, SELECT_IDENTITY, SELECT_GREATER_NAN_LAST)
+DEFINE_SELECTION(selectDouble, double, double, SELECT_IDENTITY, SELECT_GREATER_NAN_LAST)
+DEFINE_SELECTION(selectLatency, struct LatencyRecord, double, LATENCY_KEY, SELECT_GREATER_NAN_LAST)
+
+// ===================== EXTERNAL-MEMORY SELECTION =====================
+//
+// Selection over raw binary files of int32 or int64 values that do not fit
+// in memory. One pass per level:
+//   1. read a random sample of the file and pick two pivots lower <= upper
+//      whose sample ranks bracket k (as in Floyd-Rivest)
+//   2. stream the file once through a sliding mmap window, counting values
+//      above upper, equal to upper, and equal to lower, and keeping only the
+//      candidates strictly between the pivots. Candidates are buffered up to
+//      the memory budget; beyond it they spill to a temporary file
+//   3. if k falls on a pivot, that pivot is the answer; if it falls among the
+//      candidates, select in memory (or repeat on the spill file, which is
+//      much smaller than the input); if the sample was unlucky, retry with a
+//      wider bracket
+// Peak memory is the window plus the sample plus the candidate buffer, all
+// sized from the configured budget; the input itself is read once.
+
+#define EXTERNAL_WINDOW_BYTES ((size_t)64 << 20)   // Largest mapped window
+#define EXTERNAL_SAMPLE_SIZE 32768
+#define EXTERNAL_MAX_RETRIES 4
+
+#ifdef _WIN32
+#define fseek64 _fseeki64
+#define ftell64 _ftelli64
+#else
+#define fseek64 fseeko
+#define ftell64 ftello
+#endif
+
+// Options for externalSelectKthLargest()
+struct ExternalSelectOptions {
+    int elementBytes;        // 4 (int32) or 8 (int64)
+    size_t memoryBudget;     // Bytes for the window, sample and candidates
+};
+
+// Counters reported by externalSelectKthLargest()
+struct ExternalSelectStats {
+    int passes;              // Streaming passes (input plus spill files)
+    long long elementsRead;
+    long long spilledElements;
+    size_t peakBytes;        // Largest window + buffers held at once
+};
+
+// A read-only view of part of a file (mapped, or read into a buffer on Windows)
+struct FileWindow {
+    const unsigned char* data;
+    size_t length;
+    void* mapping;
+};
+
+// Function to expose bytes [offset, offset + length) of a file; 0 on success
+// offset must be a multiple of the page size (windows are 64 MiB aligned).
+static int openWindow(FILE* fp, long long offset, size_t length, struct FileWindow* window) {
+    window->length = length;
+#ifdef _WIN32
+    unsigned char* buffer = (unsigned char*)malloc(length);
+    if (buffer == NULL || fseek64(fp, offset, SEEK_SET) != 0 || fread(buffer, 1, length, fp) != length) {
+        free(buffer);
+        return -1;
+    }
+    window->mapping = buffer;
+    window->data = buffer;
+#else
+    void* mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fileno(fp), (off_t)offset);
+    if (mapping == MAP_FAILED) return -1;
+    madvise(mapping, length, MADV_SEQUENTIAL);
+    window->mapping = mapping;
+    window->data = (const unsigned char*)mapping;
+#endif
+    return 0;
+}
+
+// Function to release a window (its pages stop counting towards RSS)
+static void closeWindow(struct FileWindow* window) {
+#ifdef _WIN32
+    free(window->mapping);
+#else
+    munmap(window->mapping, window->length);
+#endif
+    window->mapping = NULL;
+}
+
+// Function to read element i of a file (used for sampling)
+static int readElementAt(FILE* fp, long long index, int width, int64_t* value) {
+    if (fseek64(fp, index * width, SEEK_SET) != 0) return -1;
+    if (width == 4) {
+        int32_t v;
+        if (fread(&v, sizeof(v), 1, fp) != 1) return -1;
+        *value = v;
+    } else {
+        int64_t v;
+        if (fread(&v, sizeof(v), 1, fp) != 1) return -1;
+        *value = v;
+    }
+    return 0;
+}
+
+// Comparison function for qsort (int64, descending)
+static int compareInt64Descending(const void* a, const void* b) {
+    int64_t x = *(const int64_t*)a;
+    int64_t y = *(const int64_t*)b;
+    return (x < y) - (x > y);
+}
+
+// State of one streaming pass
+struct ExternalPass {
+    int width;
+    int64_t upper, lower;
+    long long above, equalUpper, equalLower, between;
+    unsigned char* candidates;   // Buffered candidates (native width)
+    size_t buffered, capacity;   // In elements
+    FILE* spill;                 // Overflow candidates (tmpfile), NULL if none
+    int spillFailed;
+};
+
+// Function to move the buffered candidates to the spill file
+static void spillCandidates(struct ExternalPass* pass) {
+    if (pass->buffered == 0) return;
+    if (pass->spill == NULL) pass->spill = tmpfile();
+    if (pass->spill == NULL ||
+        fwrite(pass->candidates, (size_t)pass->width, pass->buffered, pass->spill) != pass->buffered) {
+        pass->spillFailed = 1;
+    }
+    pass->buffered = 0;
+}
+
+// Classifies one value; the band test is a single unsigned comparison and
+// only a few percent of the values take the inner branch
+#define EXTERNAL_CLASSIFY(TYPE, value)                                              \
+    do {                                                                            \
+        pass->above += ((value) > pass->upper);                                    \
+        if ((uint64_t)(value) - (uint64_t)pass->lower <= span) {                   \
+            if ((value) == pass->upper) {                                          \
+                pass->equalUpper++;                                                \
+            } else if ((value) == pass->lower) {                                   \
+                pass->equalLower++;                                                \
+            } else {                                                               \
+                if (pass->buffered == pass->capacity) spillCandidates(pass);       \
+                ((TYPE*)pass->candidates)[pass->buffered++] = (TYPE)(value);       \
+                pass->between++;                                                   \
+            }                                                                      \
+        }                                                                          \
+    } while (0)
+
+// Function to stream n elements of fp through the window and classify them
+static int streamPass(FILE* fp, long long n, size_t windowBytes, struct ExternalPass* pass) {
+    uint64_t span = (uint64_t)pass->upper - (uint64_t)pass->lower;
+    long long totalBytes = n * pass->width;
+    
+    for (long long offset = 0; offset < totalBytes; offset += (long long)windowBytes) {
+        size_t length = (totalBytes - offset < (long long)windowBytes) ? (size_t)(totalBytes - offset)
+                                                                       : windowBytes;
+        struct FileWindow window;
+        if (openWindow(fp, offset, length, &window) != 0) return -1;
+        
+        size_t count = length / (size_t)pass->width;
+        if (pass->width == 4) {
+            const int32_t* values = (const int32_t*)window.data;
+            for (size_t i = 0; i < count; i++) EXTERNAL_CLASSIFY(int32_t, (int64_t)values[i]);
+        } else {
+            const int64_t* values = (const int64_t*)window.data;
+            for (size_t i = 0; i < count; i++) EXTERNAL_CLASSIFY(int64_t, values[i]);
+        }
+        closeWindow(&window);
+    }
+    return pass->spillFailed ? -1 : 0;
+}
+
+// Function to select the kth largest of the n elements in fp
+// Recurses on the spill file when the candidates did not fit the budget.
+static int externalSelectFile(FILE* fp, long long n, long long k, const struct ExternalSelectOptions* options,
+                              unsigned long long seed, int64_t* result, struct ExternalSelectStats* stats) {
+    int width = options->elementBytes;
+    
+    // Budget split: window (at most a quarter), sample, candidate buffer
+    size_t windowBytes = EXTERNAL_WINDOW_BYTES;
+    while (windowBytes > ((size_t)64 << 10) && windowBytes > options->memoryBudget / 4) windowBytes /= 2;
+    long long sampleSize = EXTERNAL_SAMPLE_SIZE;
+    if (sampleSize > n) sampleSize = n;
+    size_t sampleBytes = (size_t)sampleSize * sizeof(int64_t);
+    size_t candidateBytes = options->memoryBudget > windowBytes + sampleBytes
+                          ? options->memoryBudget - windowBytes - sampleBytes : options->memoryBudget / 4;
+    if (candidateBytes < 4096) candidateBytes = 4096;
+    
+    // Small enough to hold outright: read it all and select in memory
+    if ((size_t)(n * width) <= candidateBytes) {
+        unsigned char* all = (unsigned char*)malloc((size_t)(n * width) + 1);
+        if (all == NULL || fseek64(fp, 0, SEEK_SET) != 0 || fread(all, (size_t)width, (size_t)n, fp) != (size_t)n) {
+            free(all);
+            return -1;
+        }
+        stats->passes++;
+        stats->elementsRead += n;
+        if (stats->peakBytes < (size_t)(n * width)) stats->peakBytes = (size_t)(n * width);
+        if (width == 4) {
+            *result = selectKthLargest((int*)all, (int)n, (int)k);
+        } else {
+            *result = ((int64_t*)all)[selectInt64InPlace((int64_t*)all, (size_t)n, (size_t)k)];
+        }
+        free(all);
+        return 0;
+    }
+    
+    double gapScale = 1.0;
+    for (int attempt = 0; attempt < EXTERNAL_MAX_RETRIES; attempt++, gapScale *= 4.0) {
+        // 1. Sample and bracket k's expected sample rank
+        int64_t* sample = (int64_t*)malloc(sampleBytes);
+        for (long long i = 0; i < sampleSize; i++) {
+            if (readElementAt(fp, (long long)(nextRandom(&seed) % (unsigned long long)n), width, &sample[i]) != 0) {
+                free(sample);
+                return -1;
+            }
+        }
+        qsort(sample, (size_t)sampleSize, sizeof(int64_t), compareInt64Descending);
+        double center = (double)k * sampleSize / n;
+        double gap = gapScale * sqrt(sampleSize * log((double)n)) + 1.0;
+        long long upperRank = (long long)(center - gap);
+        long long lowerRank = (long long)(center + gap);
+        if (upperRank < 1) upperRank = 1;
+        if (lowerRank > sampleSize) lowerRank = sampleSize;
+        
+        struct ExternalPass pass;
+        memset(&pass, 0, sizeof(pass));
+        pass.width = width;
+        // Near either end the bracket is left open instead of trusting the sample extremes
+        int64_t typeMax = (width == 4) ? INT32_MAX : INT64_MAX;
+        int64_t typeMin = (width == 4) ? INT32_MIN : INT64_MIN;
+        pass.upper = (center - gap < 1.0) ? typeMax : sample[upperRank - 1];
+        pass.lower = (center + gap > (double)sampleSize) ? typeMin : sample[lowerRank - 1];
+        free(sample);
+        pass.capacity = candidateBytes / (size_t)width;
+        pass.candidates = (unsigned char*)malloc(pass.capacity * (size_t)width);
+        size_t held = windowBytes + pass.capacity * (size_t)width;
+        if (stats->peakBytes < held) stats->peakBytes = held;
+        
+        // 2. One streaming pass
+        int status = streamPass(fp, n, windowBytes, &pass);
+        stats->passes++;
+        stats->elementsRead += n;
+        if (status != 0) {
+            free(pass.candidates);
+            if (pass.spill) fclose(pass.spill);
+            return -1;
+        }
+        
+        // 3. Locate k among the buckets
+        long long rank = k - pass.above;
+        int found = 0;
+        if (rank < 1) {
+            found = 0;                                   // Above the bracket: unlucky sample
+        } else if (rank <= pass.equalUpper) {
+            *result = pass.upper;
+            found = 1;
+        } else if ((rank -= pass.equalUpper) <= pass.between) {
+            if (pass.spill == NULL) {
+                if (width == 4) {
+                    *result = selectKthLargest((int*)pass.candidates, (int)pass.buffered, (int)rank);
+                } else {
+                    int64_t* band = (int64_t*)pass.candidates;
+                    *result = band[selectInt64InPlace(band, pass.buffered, (size_t)rank)];
+                }
+                found = 1;
+            } else {
+                // The candidates overflowed the budget: repeat on the spill file
+                spillCandidates(&pass);
+                free(pass.candidates);
+                pass.candidates = NULL;
+                stats->spilledElements += pass.between;
+                fflush(pass.spill);
+                status = pass.spillFailed ? -1
+                       : externalSelectFile(pass.spill, pass.between, rank, options, seed, result, stats);
+                fclose(pass.spill);
+                return status;
+            }
+        } else if ((rank -= pass.between) <= pass.equalLower && pass.upper != pass.lower) {
+            *result = pass.lower;
+            found = 1;
+        }
+        
+        free(pass.candidates);
+        if (pass.spill) fclose(pass.spill);
+        if (found) return 0;
+    }
+    return -1;
+}
+
+// Function to find the kth largest element of a binary file of int32 or
+// int64 values without loading it; returns 0 on success
+int externalSelectKthLargest(const char* path, long long k, const struct ExternalSelectOptions* options,
+                             int64_t* result, struct ExternalSelectStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (options->elementBytes != 4 && options->elementBytes != 8) return -1;
+    
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return -1;
+    fseek64(fp, 0, SEEK_END);
+    long long n = ftell64(fp) / options->elementBytes;
+    if (n <= 0 || k < 1 || k > n) {
+        fclose(fp);
+        return -1;
+    }
+    
+    ensurePartitionKernel();
+    int status = externalSelectFile(fp, n, k, options, 0xE77E5EEDULL ^ (unsigned long long)n, result, stats);
+    fclose(fp);
+    return status;
+}
+
+// Function to find the kth largest element with a chosen algorithm
+// The input is copied first, so arr is left untouched.
+int findKthLargestWith(const int arr[], int n, int k, enum SelectAlgorithm algorithm) {
+    if (n <= 0 || k < 1 || k > n) return -1;
+    
+    if (algorithm == SELECT_FLOYD_RIVEST) {
+        return floydRivestSelect(arr, n, k);         // Read-only, no copy needed
+    }
+    if (algorithm == SELECT_PARALLEL) {
+        // Copy mode never writes arr, so the defensive copy is skipped
+        struct ParallelSelectOptions options = {0, 0};
+        return parallelSelectKthLargest((int*)arr, (size_t)n, (size_t)k, &options);
+    }
+    
+    int* tempArr = (int*)malloc(n * sizeof(int));
+    memcpy(tempArr, arr, n * sizeof(int));
+    
+    int result;
+    switch (algorithm) {
+        case SELECT_QUICKSELECT:
+            result = quickSelect(tempArr, 0, n - 1, k);
+            break;
+        case SELECT_QUICKSELECT_3WAY:
+            result = quickSelect3Way(tempArr, 0, n - 1, k);
+            break;
+        case SELECT_INTROSELECT:
+        default:
+            result = selectKthLargest(tempArr, n, k);
+            break;
+    }
+    
+    free(tempArr);
+    return result;
+}
+
+// Function to demonstrate with step-by-step execution
+void demonstrateAlgorithm(int arr[], int n, int k) {
+    printf("=== ALGORITHM DEMONSTRATION ===\n");
+    printf("Problem: Find the %d%s largest element in the array\n", 
+           k, (k == 1) ? "st" : (k == 2) ? "nd" : (k == 3) ? "rd" : "th");
+    printf("Approach: QuickSelect (Divide and Conquer)\n\n");
+    
+    printArray(arr, n, "Input array");
+    printf("k = %d\n\n", k);
+    
+    int result = findKthLargest(arr, n, k);
+    
+    printf("\n=== VERIFICATION ===\n");
+    // Sort array to verify result
+    int* sortedArr = (int*)malloc(n * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        sortedArr[i] = arr[i];
+    }
+    
+    // Simple bubble sort for verification
+    for (int i = 0; i < n - 1; i++) {
+        for (int j = 0; j < n - i - 1; j++) {
+            if (sortedArr[j] < sortedArr[j + 1]) {
+                swap(&sortedArr[j], &sortedArr[j + 1]);
+            }
+        }
+    }
+    
+    printArray(sortedArr, n, "Sorted array (descending)");
+    printf("The %d%s largest element is: %d\n", 
+           k, (k == 1) ? "st" : (k == 2) ? "nd" : (k == 3) ? "rd" : "th", result);
+    printf("Verification: sortedArr[%d] = %d ✓\n", k-1, sortedArr[k-1]);
+    printf("Introselect (production path): %d\n",
+           findKthLargestWith(arr, n, k, SELECT_INTROSELECT));
+    
+    free(sortedArr);
+}
+
+// Function to analyze time complexity
+void analyzeTimeComplexity() {
+    printf("\n=== TIME COMPLEXITY ANALYSIS ===\n");
+    printf("QuickSelect Algorithm:\n");
+    printf("• Best Case: O(n) - When pivot divides array into equal halves\n");
+    printf("• Average Case: O(n) - Expected linear time\n");
+    printf("• Worst Case: O(n²) - When pivot is always the smallest/largest\n");
+    printf("\nRecurrence Relation:\n");
+    printf("• T(n) = T(n/2) + O(n) in average case\n");
+    printf("• T(n) = T(n-1) + O(n) in worst case\n");
+    printf("\nSpace Complexity: O(log n) for recursion stack (average case)\n");
+    printf("\nAdvantage over full sorting:\n");
+    printf("• QuickSelect: O(n) average case\n");
+    printf("• Full QuickSort: O(n log n)\n");
+    printf("\nIntroselect (production path):\n");
+    printf("• Ninther / median-of-3 pivots defeat sorted and reverse-sorted input\n");
+    printf("• Falls back to median-of-medians when the range stops halving\n");
+    printf("• Worst Case: O(n), iterative, O(1) extra space apart from the fallback\n");
+}
+
+// Test function with multiple examples
+void runTests() {
+    printf("=== ADDITIONAL TEST CASES ===\n");
+    
+    // Test case 1
+    int test1[] = {3, 2, 1, 5, 6, 4};
+    int n1 = 6, k1 = 2;
+    printf("\nTest 1: ");
+    printArray(test1, n1, "Array");
+    printf("k = %d, Result = %d\n", k1, findKthLargest(test1, n1, k1));
+    
+    // Test case 2
+    int test2[] = {3, 2, 3, 1, 2, 4, 5, 5, 6};
+    int n2 = 9, k2 = 4;
+    printf("\nTest 2: ");
+    printArray(test2, n2, "Array");
+    printf("k = %d, Result = %d\n", k2, findKthLargest(test2, n2, k2));
+    
+    // Test case 3
+    int test3[] = {1};
+    int n3 = 1, k3 = 1;
+    printf("\nTest 3: ");
+    printArray(test3, n3, "Array");
+    printf("k = %d, Result = %d\n", k3, findKthLargest(test3, n3, k3));
+    
+    // Test case 4: duplicate-heavy input with three-way partitioning
+    int test4[] = {5, 5, 1, 5, 2, 5, 5, 5};
+    int n4 = 8, k4 = 3;
+    printf("\nTest 4 (three-way partition): ");
+    printArray(test4, n4, "Array");
+    printf("k = %d, Result = %d\n", k4, findKthLargestWith(test4, n4, k4, SELECT_QUICKSELECT_3WAY));
+    
+    // Test case 5: several ranks from one multiselect pass
+    int test5[] = {3, 2, 3, 1, 2, 4, 5, 5, 6};
+    int n5 = 9;
+    int ranks5[] = {1, 4, 9};
+    int results5[3];
+    printf("\nTest 5 (multiselect): ");
+    printArray(test5, n5, "Array");
+    selectKthLargestMany(test5, n5, ranks5, 3, results5);
+    printf("k = 1, 4, 9, Results = %d, %d, %d\n", results5[0], results5[1], results5[2]);
+    
+    // Test case 6: the same kind of query over data arriving in chunks
+    int chunkA[] = {3, 2, 1};
+    int chunkB[] = {5, 6};
+    int chunkC[] = {4};
+    int kth;
+    struct TopKStream* stream = createTopKStream(2, TOPK_HEAP);
+    printf("\nTest 6 (streaming, k = 2): chunks {3 2 1}, {5 6}, {4}\n");
+    topKPush(stream, chunkA, 3);
+    topKCurrent(stream, &kth);
+    printf("After chunk 1: 2nd largest so far = %d\n", kth);
+    topKPush(stream, chunkB, 2);
+    topKCurrent(stream, &kth);
+    printf("After chunk 2: 2nd largest so far = %d\n", kth);
+    topKPush(stream, chunkC, 1);
+    topKCurrent(stream, &kth);
+    printf("After chunk 3: 2nd largest so far = %d\n", kth);
+    freeTopKStream(stream);
+    
+    // Test case 7: records ranked by a projected key, reported by index
+    struct LatencyRecord requests[] = {{12.5, 101}, {48.0, 102}, {3.2, 103}, {48.0, 104}, {27.9, 105}};
+    size_t slowest = selectLatencyIndex(requests, 5, 3);
+    printf("\nTest 7 (typed selection, k = 3): latencies {12.5 48.0 3.2 48.0 27.9}\n");
+    printf("3rd slowest request: id %llu at index %zu (%.1f ms)\n",
+           (unsigned long long)requests[slowest].requestId, slowest, requests[slowest].latencyMs);
+}
+
+// ===================== BENCHMARKS =====================
+
+// Input distributions for the selection benchmark
+enum BenchDistribution {
+    DIST_RANDOM,
+    DIST_SORTED,
+    DIST_REVERSED,
+    DIST_FEW_UNIQUE
+};
+
+static const char* const distributionNames[] = {"random", "sorted", "reversed", "few-unique"};
+
+#define DUPLICATE_BENCH_MAX 50000
+#define STREAM_CHUNK 4096
+
+// Function to fill arr with n values from a distribution
+void generateInput(int arr[], int n, enum BenchDistribution distribution, unsigned long long seed) {
+    for (int i = 0; i < n; i++) {
+        switch (distribution) {
+            case DIST_RANDOM:     arr[i] = (int)(unsigned)nextRandom(&seed); break;
+            case DIST_SORTED:     arr[i] = i; break;
+            case DIST_REVERSED:   arr[i] = n - i; break;
+            case DIST_FEW_UNIQUE: arr[i] = (int)(nextRandom(&seed) % 16); break;
+        }
+    }
+}
+
+// Function to time one selection of the median on a fresh copy of input
+// (with the demonstration traces off)
+static double timeSelection(const int input[], int work[], int n, int k,
+                            enum SelectAlgorithm algorithm, int* result) {
+    memcpy(work, input, (size_t)n * sizeof(int));
+    int tracing = setTracing(0);
+    double start = nowSeconds();
+    switch (algorithm) {
+        case SELECT_QUICKSELECT:      *result = quickSelect(work, 0, n - 1, k); break;
+        case SELECT_QUICKSELECT_3WAY: *result = quickSelect3Way(work, 0, n - 1, k); break;
+        case SELECT_FLOYD_RIVEST:     *result = floydRivestSelect(work, n, k); break;
+        default:                      *result = selectKthLargest(work, n, k); break;
+    }
+    double seconds = nowSeconds() - start;
+    setTracing(tracing);
+    return seconds;
+}
+
+// Function to benchmark the demonstration QuickSelect against introselect
+// with every partition kernel the CPU supports, and the parallel selection
+void runBenchmarks(int n, unsigned long long seed, int threads) {
+    int* input = (int*)malloc((size_t)n * sizeof(int));
+    int* work = (int*)malloc((size_t)n * sizeof(int));
+    if (input == NULL || work == NULL) {
+        printf("Not enough memory for %d elements\n", n);
+        free(input);
+        free(work);
+        return;
+    }
+    int k = n / 2 + 1;
+    if (threads <= 0) threads = defaultThreadCount();
+    ensurePartitionKernel();
+    enum PartitionKernelType previous = activeKernel;
+    
+    printf("=== SELECTION BENCHMARK (n = %d, k = %d) ===\n", n, k);
+    printf("%-11s %-22s %10s %9s\n", "input", "algorithm", "time (ms)", "speedup");
+    
+    for (int d = DIST_RANDOM; d <= DIST_FEW_UNIQUE; d++) {
+        generateInput(input, n, (enum BenchDistribution)d, seed);
+        double baseline = 0.0;
+        int expected = 0, haveExpected = 0;
+        
+        // The demonstration QuickSelect is quadratic (and recurses n deep)
+        // on sorted or duplicate-heavy input, so it only runs on random input
+        if (d == DIST_RANDOM) {
+            baseline = timeSelection(input, work, n, k, SELECT_QUICKSELECT, &expected);
+            haveExpected = 1;
+            printf("%-11s %-22s %10.2f %9s\n", distributionNames[d], "quickselect",
+                   baseline * 1000.0, "1.00x");
+        } else {
+            printf("%-11s %-22s %10s %9s\n", distributionNames[d], "quickselect", "skipped", "-");
+        }
+        
+        for (int kernel = KERNEL_SCALAR; kernel <= KERNEL_AVX512; kernel++) {
+            if (!selectPartitionKernel((enum PartitionKernelType)kernel)) continue;
+            int result;
+            double seconds = timeSelection(input, work, n, k, SELECT_INTROSELECT, &result);
+            
+            char label[32];
+            snprintf(label, sizeof(label), "introselect/%s", kernelNames[kernel]);
+            char speedup[16] = "-";
+            if (baseline > 0.0) snprintf(speedup, sizeof(speedup), "%.2fx", baseline / seconds);
+            printf("%-11s %-22s %10.2f %9s%s\n", distributionNames[d], label, seconds * 1000.0,
+                   speedup, (haveExpected && result != expected) ? "  MISMATCH" : "");
+            if (!haveExpected) {
+                expected = result;
+                haveExpected = 1;
+            }
+        }
+        selectPartitionKernel(previous);
+        
+        int frResult;
+        double frSeconds = timeSelection(input, work, n, k, SELECT_FLOYD_RIVEST, &frResult);
+        char frSpeedup[16] = "-";
+        if (baseline > 0.0) snprintf(frSpeedup, sizeof(frSpeedup), "%.2fx", baseline / frSeconds);
+        printf("%-11s %-22s %10.2f %9s%s\n", distributionNames[d], "floyd-rivest", frSeconds * 1000.0,
+               frSpeedup, (frResult != expected) ? "  MISMATCH" : "");
+        
+        for (int inPlace = 0; inPlace <= 1; inPlace++) {
+            struct ParallelSelectOptions options = {threads, inPlace};
+            memcpy(work, input, (size_t)n * sizeof(int));
+            double start = nowSeconds();
+            int result = parallelSelectKthLargest(work, (size_t)n, (size_t)k, &options);
+            double seconds = nowSeconds() - start;
+            
+            char label[32];
+            snprintf(label, sizeof(label), "parallel/%s x%d", inPlace ? "in-place" : "copy", threads);
+            char speedup[16] = "-";
+            if (baseline > 0.0) snprintf(speedup, sizeof(speedup), "%.2fx", baseline / seconds);
+            printf("%-11s %-22s %10.2f %9s%s\n", distributionNames[d], label, seconds * 1000.0,
+                   speedup, (result != expected) ? "  MISMATCH" : "");
+        }
+    }
+    
+    free(input);
+    free(work);
+}
+
+// Function to benchmark two-way against three-way QuickSelect on inputs
+// with few distinct values (the demonstration routines, traces off)
+void runDuplicateBenchmark(int n, unsigned long long seed) {
+    static const int cardinalities[] = {1, 2, 4, 16, 256, 65536};
+    int count = (int)(sizeof(cardinalities) / sizeof(cardinalities[0]));
+    
+    // Two-way QuickSelect recurses once per duplicate it peels off, so the
+    // comparison is capped at a size it can finish (and its stack survives)
+    if (n > DUPLICATE_BENCH_MAX) n = DUPLICATE_BENCH_MAX;
+    int* input = (int*)malloc((size_t)n * sizeof(int));
+    int* work = (int*)malloc((size_t)n * sizeof(int));
+    int k = n / 2 + 1;
+    
+    printf("\n=== LOW-CARDINALITY BENCHMARK (n = %d, k = %d) ===\n", n, k);
+    printf("%-9s %14s %14s %14s %9s\n", "distinct", "2-way (ms)", "3-way (ms)", "intro (ms)", "speedup");
+    
+    for (int c = 0; c < count; c++) {
+        for (int i = 0; i < n; i++) {
+            input[i] = (int)(nextRandom(&seed) % (unsigned long long)cardinalities[c]);
+        }
+        int twoWay, threeWay, intro;
+        double twoWaySeconds = timeSelection(input, work, n, k, SELECT_QUICKSELECT, &twoWay);
+        double threeWaySeconds = timeSelection(input, work, n, k, SELECT_QUICKSELECT_3WAY, &threeWay);
+        double introSeconds = timeSelection(input, work, n, k, SELECT_INTROSELECT, &intro);
+        
+        printf("%-9d %14.3f %14.3f %14.3f %8.1fx%s\n", cardinalities[c],
+               twoWaySeconds * 1000.0, threeWaySeconds * 1000.0, introSeconds * 1000.0,
+               twoWaySeconds / threeWaySeconds,
+               (twoWay != threeWay || twoWay != intro) ? "  MISMATCH" : "");
+    }
+    
+    free(input);
+    free(work);
+}
+
+// Function to benchmark one multiselect against separate selections
+// for 4 percentiles and for larger evenly spaced rank sets
+void runMultiRankBenchmark(int n, unsigned long long seed) {
+    static const int rankCounts[] = {4, 16, 64};
+    int* input = (int*)malloc((size_t)n * sizeof(int));
+    int* work = (int*)malloc((size_t)n * sizeof(int));
+    generateInput(input, n, DIST_RANDOM, seed);
+    
+    printf("\n=== MULTI-RANK BENCHMARK (n = %d, random) ===\n", n);
+    printf("%-6s %16s %16s %9s\n", "ranks", "separate (ms)", "multi (ms)", "speedup");
+    
+    for (int c = 0; c < (int)(sizeof(rankCounts) / sizeof(rankCounts[0])); c++) {
+        int m = rankCounts[c];
+        if (m > n) break;
+        int* ranks = (int*)malloc((size_t)m * sizeof(int));
+        int* results = (int*)malloc((size_t)m * sizeof(int));
+        int* expected = (int*)malloc((size_t)m * sizeof(int));
+        if (m == 4) {
+            // p99.9, p99, p90, p50 as kth-largest ranks (ascending)
+            static const double tails[] = {0.001, 0.01, 0.1, 0.5};
+            for (int i = 0; i < 4; i++) ranks[i] = (int)(tails[i] * n) + 1;
+        } else {
+            for (int i = 0; i < m; i++) ranks[i] = (int)((long long)n * i / m) + 1;
+        }
+        
+        // Separate: what calling findKthLargest once per rank costs
+        double start = nowSeconds();
+        for (int i = 0; i < m; i++) {
+            memcpy(work, input, (size_t)n * sizeof(int));
+            expected[i] = selectKthLargest(work, n, ranks[i]);
+        }
+        double separate = nowSeconds() - start;
+        
+        start = nowSeconds();
+        memcpy(work, input, (size_t)n * sizeof(int));
+        selectKthLargestMany(work, n, ranks, m, results);
+        double multi = nowSeconds() - start;
+        int mismatch = memcmp(results, expected, (size_t)m * sizeof(int)) != 0;
+        
+        printf("%-6d %16.2f %16.2f %8.1fx%s\n", m, separate * 1000.0, multi * 1000.0,
+               separate / multi, mismatch ? "  MISMATCH" : "");
+        free(ranks);
+        free(results);
+        free(expected);
+    }
+    
+    free(input);
+    free(work);
+}
+
+// Comparison function for qsort (double, descending)
+static int compareDoubleDescending(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x < y) - (x > y);
+}
+
+// Function to benchmark the type-specialized selections against qsort,
+// whose comparisons go through a function pointer
+void runTypedBenchmark(int n, unsigned long long seed) {
+    int64_t* longs = (int64_t*)malloc((size_t)n * sizeof(int64_t));
+    int64_t* longWork = (int64_t*)malloc((size_t)n * sizeof(int64_t));
+    double* doubles = (double*)malloc((size_t)n * sizeof(double));
+    double* doubleWork = (double*)malloc((size_t)n * sizeof(double));
+    struct LatencyRecord* records = (struct LatencyRecord*)malloc((size_t)n * sizeof(struct LatencyRecord));
+    for (int i = 0; i < n; i++) {
+        longs[i] = (int64_t)nextRandom(&seed);
+        doubles[i] = (double)(nextRandom(&seed) >> 11) * 0x1.0p-53 * 1000.0;
+        records[i].latencyMs = doubles[i];
+        records[i].requestId = (uint64_t)i;
+    }
+    size_t k = (size_t)n / 2 + 1;
+    
+    printf("\n=== TYPED SELECTION BENCHMARK (n = %d, median) ===\n", n);
+    printf("%-26s %12s %12s\n", "Selection", "Time (ms)", "Matches");
+    
+    memcpy(longWork, longs, (size_t)n * sizeof(int64_t));
+    double start = nowSeconds();
+    qsort(longWork, (size_t)n, sizeof(int64_t), compareInt64Descending);
+    double seconds = nowSeconds() - start;
+    int64_t expectedLong = longWork[k - 1];
+    printf("%-26s %12.2f %12s\n", "int64 qsort", seconds * 1000.0, "yes");
+    
+    memcpy(longWork, longs, (size_t)n * sizeof(int64_t));
+    start = nowSeconds();
+    size_t position = selectInt64InPlace(longWork, (size_t)n, k);
+    seconds = nowSeconds() - start;
+    printf("%-26s %12.2f %12s\n", "int64 in place", seconds * 1000.0,
+           longWork[position] == expectedLong ? "yes" : "NO");
+    
+    start = nowSeconds();
+    size_t index = selectInt64Index(longs, (size_t)n, k);
+    seconds = nowSeconds() - start;
+    printf("%-26s %12.2f %12s\n", "int64 index", seconds * 1000.0, longs[index] == expectedLong ? "yes" : "NO");
+    
+    memcpy(doubleWork, doubles, (size_t)n * sizeof(double));
+    start = nowSeconds();
+    qsort(doubleWork, (size_t)n, sizeof(double), compareDoubleDescending);
+    seconds = nowSeconds() - start;
+    double expectedDouble = doubleWork[k - 1];
+    printf("%-26s %12.2f %12s\n", "double qsort", seconds * 1000.0, "yes");
+    
+    memcpy(doubleWork, doubles, (size_t)n * sizeof(double));
+    start = nowSeconds();
+    position = selectDoubleInPlace(doubleWork, (size_t)n, k);
+    seconds = nowSeconds() - start;
+    printf("%-26s %12.2f %12s\n", "double in place", seconds * 1000.0,
+           doubleWork[position] == expectedDouble ? "yes" : "NO");
+    
+    start = nowSeconds();
+    index = selectLatencyIndex(records, (size_t)n, k);
+    seconds = nowSeconds() - start;
+    printf("%-26s %12.2f %12s\n", "latency record index", seconds * 1000.0,
+           records[index].latencyMs == expectedDouble ? "yes" : "NO");
+    
+    free(longs);
+    free(longWork);
+    free(doubles);
+    free(doubleWork);
+    free(records);
+}
+
+// Function to benchmark the streaming top-k strategies against selecting
+// from the whole data set at the end (which needs all of it in memory)
+void runStreamingBenchmark(int n, unsigned long long seed) {
+    static const int topSizes[] = {10, 1000, 100000};
+    int* input = (int*)malloc((size_t)n * sizeof(int));
+    int* work = (int*)malloc((size_t)n * sizeof(int));
+    generateInput(input, n, DIST_RANDOM, seed);
+    
+    printf("\n=== STREAMING TOP-K BENCHMARK (n = %d, chunks of %d) ===\n", n, STREAM_CHUNK);
+    printf("%-8s %12s %12s %14s\n", "k", "heap (ms)", "buffer (ms)", "in-memory (ms)");
+    
+    for (int c = 0; c < (int)(sizeof(topSizes) / sizeof(topSizes[0])); c++) {
+        int k = topSizes[c];
+        if (k > n) break;
+        int values[2];
+        double seconds[2];
+        for (int mode = TOPK_HEAP; mode <= TOPK_BUFFER; mode++) {
+            double start = nowSeconds();
+            struct TopKStream* stream = createTopKStream(k, (enum TopKMode)mode);
+            for (int offset = 0; offset < n; offset += STREAM_CHUNK) {
+                int chunk = (n - offset < STREAM_CHUNK) ? n - offset : STREAM_CHUNK;
+                topKPush(stream, input + offset, (size_t)chunk);
+            }
+            topKCurrent(stream, &values[mode]);
+            seconds[mode] = nowSeconds() - start;
+            freeTopKStream(stream);
+        }
+        int expected;
+        double inMemory = timeSelection(input, work, n, k, SELECT_INTROSELECT, &expected);
+        
+        printf("%-8d %12.2f %12.2f %14.2f%s\n", k, seconds[0] * 1000.0, seconds[1] * 1000.0,
+               inMemory * 1000.0, (values[0] != expected || values[1] != expected) ? "  MISMATCH" : "");
+    }
+    
+    free(input);
+    free(work);
+}
+
+// Function to read integers from stdin in chunks and report the top-k
+int runStreamingTopK(int k, enum TopKMode mode) {
+    struct TopKStream* stream = createTopKStream(k, mode);
+    if (stream == NULL) return 1;
+    
+    int chunk[STREAM_CHUNK];
+    size_t filled = 0;
+    while (scanf("%d", &chunk[filled]) == 1) {
+        if (++filled == STREAM_CHUNK) {
+            topKPush(stream, chunk, filled);
+            filled = 0;
+        }
+    }
+    topKPush(stream, chunk, filled);
+    
+    int kth;
+    if (topKCurrent(stream, &kth) != 0) {
+        printf("Only %lld values read; need at least %d\n", stream->seen, k);
+        freeTopKStream(stream);
+        return 1;
+    }
+    int* top = (int*)malloc((size_t)k * sizeof(int));
+    int count = topKSnapshot(stream, top);
+    printf("Values read: %lld\n", stream->seen);
+    printf("%d%s largest: %d\n", k, (k == 1) ? "st" : (k == 2) ? "nd" : (k == 3) ? "rd" : "th", kth);
+    printArray(top, count, "Top values");
+    
+    free(top);
+    freeTopKStream(stream);
+    return 0;
+}
+
+// Work shared by the per-thread sketch builders
+struct SketchBuildWork {
+    const int* data;
+    int n;
+    int k;
+    unsigned long long seed;
+    struct KLLSketch** sketches;
+};
+
+// Function to build one thread's sketch over its chunk of the data
+static void buildSketchTask(int threadId, int numThreads, void* arg) {
+    struct SketchBuildWork* work = (struct SketchBuildWork*)arg;
+    size_t begin, end;
+    chunkRange((size_t)work->n, threadId, numThreads, &begin, &end);
+    struct KLLSketch* sketch = kllCreate(work->k, work->seed + (unsigned long long)threadId);
+    for (size_t offset = begin; offset < end; offset += STREAM_CHUNK) {
+        size_t chunk = (end - offset < STREAM_CHUNK) ? end - offset : STREAM_CHUNK;
+        kllUpdate(sketch, work->data + offset, chunk);
+    }
+    work->sketches[threadId] = sketch;
+}
+
+// Function to check the KLL sketch against exact selection
+// Per-thread sketches are merged (and round-tripped through a file, as a
+// separate process would), then each quantile's normalized rank error is
+// measured against the exact findKthLargest answer on the same data.
+int runSketchVerification(int n, double epsilon, int threads, unsigned long long seed) {
+    static const double percentiles[] = {1, 10, 50, 90, 99, 99.9};
+    int* data = (int*)malloc((size_t)n * sizeof(int));
+    generateInput(data, n, DIST_RANDOM, seed);
+    if (threads <= 0) threads = defaultThreadCount();
+    
+    struct SketchBuildWork work;
+    work.data = data;
+    work.n = n;
+    work.k = kllParameterForError(epsilon);
+    work.seed = seed;
+    work.sketches = (struct KLLSketch**)malloc((size_t)threads * sizeof(struct KLLSketch*));
+    
+    double start = nowSeconds();
+    runParallel(threads, buildSketchTask, &work);
+    struct KLLSketch* merged = work.sketches[0];
+    for (int t = 1; t < threads; t++) {
+        kllMerge(merged, work.sketches[t]);
+        kllFree(work.sketches[t]);
+    }
+    double buildSeconds = nowSeconds() - start;
+    
+    char path[] = "kll_verify.sketch";
+    struct KLLSketch* loaded = NULL;
+    if (kllSave(merged, path) == 0) loaded = kllLoad(path);
+    remove(path);
+    if (loaded == NULL) {
+        printf("Sketch save/load round trip failed\n");
+        loaded = merged;
+        merged = NULL;
+    }
+    
+    printf("=== KLL SKETCH VERIFICATION (n = %d, epsilon = %g, k = %d, %d threads) ===\n",
+           n, epsilon, work.k, threads);
+    printf("Sketch: %d items retained (%.1f KiB), built and merged in %.2f ms\n",
+           loaded->size, loaded->size * sizeof(int) / 1024.0, buildSeconds * 1000.0);
+    printf("%-10s %14s %14s %12s\n", "quantile", "exact", "sketch", "rank error");
+    
+    double worst = 0.0;
+    for (int i = 0; i < (int)(sizeof(percentiles) / sizeof(percentiles[0])); i++) {
+        int ascendingRank = (int)ceil(percentiles[i] / 100.0 * n);
+        if (ascendingRank < 1) ascendingRank = 1;
+        int k = n - ascendingRank + 1;
+        
+        int exact = findKthLargestWith(data, n, k, SELECT_INTROSELECT);
+        int estimate;
+        kllKthLargest(loaded, k, &estimate);
+        
+        // The estimate occupies descending ranks (greater, atLeast]
+        long long greater = 0, atLeast = 0;
+        for (int j = 0; j < n; j++) {
+            greater += (data[j] > estimate);
+            atLeast += (data[j] >= estimate);
+        }
+        long long miss = 0;
+        if (k <= greater) miss = greater + 1 - k;
+        if (k > atLeast) miss = k - atLeast;
+        double error = (double)miss / n;
+        if (error > worst) worst = error;
+        
+        char label[16];
+        snprintf(label, sizeof(label), "p%g", percentiles[i]);
+        printf("%-10s %14d %14d %11.4f%%\n", label, exact, estimate, error * 100.0);
+    }
+    printf("Worst rank error %.4f%% (target %.4f%%): %s\n", worst * 100.0, epsilon * 100.0,
+           worst <= epsilon ? "PASS" : "FAIL");
+    
+    kllFree(merged);
+    kllFree(loaded);
+    free(work.sketches);
+    free(data);
+    return worst <= epsilon ? 0 : 1;
+}
+
+// Function to report the peak resident set size in MiB (0 where unavailable)
+double peakRSSMiB(void) {
+#ifdef _WIN32
+    return 0.0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0);   // bytes
+#else
+    return usage.ru_maxrss / 1024.0;              // KiB
+#endif
+#endif
+}
+
+// Function to write n random values of the given width to a binary file
+int generateBinaryFile(const char* path, long long n, int width, unsigned long long seed) {
+    FILE* fp = fopen(path, "wb");
+    if (!fp) {
+        printf("Cannot create %s\n", path);
+        return 1;
+    }
+    int64_t block[STREAM_CHUNK];
+    for (long long written = 0; written < n; written += STREAM_CHUNK) {
+        size_t count = (n - written < STREAM_CHUNK) ? (size_t)(n - written) : STREAM_CHUNK;
+        for (size_t i = 0; i < count; i++) {
+            uint64_t r = nextRandom(&seed);
+            if (width == 4) ((int32_t*)block)[i] = (int32_t)r;
+            else block[i] = (int64_t)r;
+        }
+        fwrite(block, (size_t)width, count, fp);
+    }
+    fclose(fp);
+    printf("Wrote %lld int%d values to %s\n", n, width * 8, path);
+    return 0;
+}
+
+// Function to select from a binary file and report passes and memory
+int runExternalSelect(const char* path, long long k, int width, size_t budgetMiB) {
+    struct ExternalSelectOptions options = {width, budgetMiB << 20};
+    struct ExternalSelectStats stats;
+    int64_t result;
+    
+    double start = nowSeconds();
+    if (externalSelectKthLargest(path, k, &options, &result, &stats) != 0) {
+        printf("External selection failed (missing file, bad k, or I/O error)\n");
+        return 1;
+    }
+    double seconds = nowSeconds() - start;
+    
+    printf("=== EXTERNAL-MEMORY SELECTION (int%d, budget %zu MiB) ===\n", width * 8, budgetMiB);
+    printf("The %lldth largest element is: %lld\n", k, (long long)result);
+    printf("Passes: %d, elements read: %lld, spilled: %lld\n",
+           stats.passes, stats.elementsRead, stats.spilledElements);
+    printf("Time: %.3f s, buffers: %.1f MiB, peak RSS: %.1f MiB\n",
+           seconds, stats.peakBytes / (1024.0 * 1024.0), peakRSSMiB());
+    return 0;
+}
+
+// Function to print command-line usage
+void printUsage(const char* program) {
+    printf("Usage: %s                      interactive demonstration (reads n, elements, k)\n", program);
+    printf("       %s --bench [N] [--seed S] [--threads T] [--kernel auto|scalar|avx2|avx512]\n", program);
+    printf("       %s --topk K [--mode heap|buffer] < values.txt\n", program);
+    printf("       %s --kll-verify N [--epsilon E] [--threads T] [--seed S]\n", program);
+    printf("       %s --file PATH --k K [--width 32|64] [--budget MiB]\n", program);
+    printf("       %s --generate PATH N [--width 32|64] [--seed S]\n", program);
+    printf("  --bench N       time selection of the median of N generated ints (default 10^7),\n");
+    printf("                  then two-way vs three-way QuickSelect on few distinct values\n");
+    printf("                  and one multiselect vs separate selections for several ranks,\n");
+    printf("                  and the streaming top-k strategies\n");
+    printf("  --topk K        read integers from stdin until EOF; print the kth largest and top K\n");
+    printf("  --mode M        streaming strategy for --topk: heap (default) or buffer\n");
+    printf("  --kll-verify N  build per-thread KLL sketches over N ints, merge them and\n");
+    printf("                  check quantile rank errors against exact selection\n");
+    printf("  --epsilon E     KLL target normalized rank error (default 0.01)\n");
+    printf("  --file PATH     select the kth largest of a raw binary file of integers\n");
+    printf("                  without loading it (sampled pivots, one streaming pass)\n");
+    printf("  --width W       element width of --file/--generate in bits (default 32)\n");
+    printf("  --budget MiB    memory budget for --file (default 256)\n");
+    printf("  --generate P N  write N random integers to the binary file P\n");
+    printf("  --seed S        generator seed (default 1)\n");
+    printf("  --threads T     threads for the parallel selection (default: one per CPU)\n");
+    printf("  --kernel K      partition kernel for the production path (default: auto)\n");
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        int benchSize = 0;
+        unsigned long long seed = 1;
+        int threads = 0;
+        int topK = 0;
+        enum TopKMode topKMode = TOPK_HEAP;
+        int verifySize = 0;
+        double epsilon = 0.01;
+        const char* filePath = NULL;
+        const char* generatePath = NULL;
+        long long fileK = 0;
+        long long generateCount = 0;
+        int width = 32;
+        size_t budgetMiB = 256;
+        for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--bench") == 0) {
+                benchSize = 10000000;
+                if (i + 1 < argc && argv[i + 1][0] != '-') benchSize = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "--kll-verify") == 0 && i + 1 < argc) {
+                verifySize = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "--epsilon") == 0 && i + 1 < argc) {
+                epsilon = atof(argv[++i]);
+            } else if (strcmp(argv[i], "--file") == 0 && i + 1 < argc) {
+                filePath = argv[++i];
+            } else if (strcmp(argv[i], "--k") == 0 && i + 1 < argc) {
+                fileK = atoll(argv[++i]);
+            } else if (strcmp(argv[i], "--width") == 0 && i + 1 < argc) {
+                width = atoi(argv[++i]);
+                if (width != 32 && width != 64) {
+                    printUsage(argv[0]);
+                    return 1;
+                }
+            } else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+                budgetMiB = (size_t)atoll(argv[++i]);
+            } else if (strcmp(argv[i], "--generate") == 0 && i + 2 < argc) {
+                generatePath = argv[++i];
+                generateCount = atoll(argv[++i]);
+            } else if (strcmp(argv[i], "--topk") == 0 && i + 1 < argc) {
+                topK = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc) {
+                i++;
+                if (strcmp(argv[i], "heap") == 0) {
+                    topKMode = TOPK_HEAP;
+                } else if (strcmp(argv[i], "buffer") == 0) {
+                    topKMode = TOPK_BUFFER;
+                } else {
+                    printUsage(argv[0]);
+                    return 1;
+                }
+            } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+                threads = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+                seed = strtoull(argv[++i], NULL, 10);
+            } else if (strcmp(argv[i], "--kernel") == 0 && i + 1 < argc) {
+                const char* name = argv[++i];
+                int chosen = -1;
+                for (int kernel = KERNEL_AUTO; kernel <= KERNEL_AVX512; kernel++) {
+                    if (strcmp(name, kernelNames[kernel]) == 0) chosen = kernel;
+                }
+                if (chosen < 0 || !selectPartitionKernel((enum PartitionKernelType)chosen)) {
+                    printf("Partition kernel '%s' is not available on this CPU\n", name);
+                    return 1;
+                }
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        if (generatePath != NULL) return generateBinaryFile(generatePath, generateCount, width / 8, seed);
+        if (filePath != NULL) return runExternalSelect(filePath, fileK, width / 8, budgetMiB);
+        if (topK > 0) return runStreamingTopK(topK, topKMode);
+        if (verifySize > 0) return runSketchVerification(verifySize, epsilon, threads, seed);
+        if (benchSize <= 0) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        runBenchmarks(benchSize, seed, threads);
+        runDuplicateBenchmark(benchSize, seed);
+        runMultiRankBenchmark(benchSize, seed);
+        runTypedBenchmark(benchSize, seed);
+        runStreamingBenchmark(benchSize, seed);
+        return 0;
+    }
+    
+
     printf("=== KTH LARGEST ELEMENT USING QUICKSELECT ===\n");
     printf("Divide and Conquer Approach\n\n");
     
@@ -3,9 +3,440 @@
 #include <stdbool.h>
 #include <string.h>
 #include <limits.h>
+#include <stdint.h>
+#include <pthread.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+#include <time.h>
 
-#define MAX_INTERSECTIONS 100
-#define MAX_ROADS 1000
+#include "../common/arena.h"
+#include "../common/parallel.h"
+#include "../common/support.h"
+
+// Quiet mode silences the per-road messages and BFS traversal printouts
+// (used by the benchmarks, where printing would dominate the timings)
+static bool quietMode = false;
+#define CITY_LOG(...) do { if (!quietMode) printf(__VA_ARGS__); } while (0)
+
+// ===================== DYNAMIC CONNECTIVITY =====================
+//
+// Holm-de Lichtenberg-Thorup (HDT) dynamic connectivity over the open roads.
+// Every open road has a level in 0..log2(n). F_i is a spanning forest of the
+// open roads with level >= i (so F_0 spans the whole open network and
+// F_0 ⊇ F_1 ⊇ ...), and each tree of F_i has at most n / 2^i intersections.
+// Every forest is stored as Euler tours in treaps (ET-trees), so linking,
+// cutting and "same tree?" take O(log n).
+//
+//   open a road:  link it into F_0 if it joins two trees, otherwise keep it
+//                 as a non-tree road at level 0
+//   close a road: a non-tree road is just forgotten; a tree road is cut from
+//                 F_0..F_level and a replacement is searched for from its
+//                 level down to 0, scanning the smaller of the two halves
+//                 and promoting the roads it rejects one level up (which
+//                 pays for the scan: amortized O(log^2 n) per update)
+//   connected?    compare the roots of the two ET-trees in F_0
+//   components    numVertices - number of tree roads in F_0
+
+#define DC_MAX_LEVELS 32
+
+// ET-tree node flags (own and subtree-aggregated)
+#define ET_NONTREE 1      // Vertex node with non-tree roads at this level
+#define ET_TREE 2         // Arc of a tree road whose level is this level
+
+// A node of an Euler tour: either the single occurrence of a vertex or one
+// of the two arcs (u -> v, v -> u) of a tree road
+typedef struct ETNode {
+    struct ETNode* left;
+    struct ETNode* right;
+    struct ETNode* parent;
+    unsigned priority;
+    int size;                 // Nodes in this subtree
+    unsigned char flags;
+    unsigned char subtreeFlags;
+    int vertex;               // Vertex nodes: the vertex; arcs: -1
+    int edge;                 // Arcs: the road id
+    int* nontree;             // Vertex nodes: non-tree roads at this level
+    int nontreeCount;
+    int nontreeCapacity;
+} ETNode;
+
+enum DCEdgeState {
+    DC_EDGE_ABSENT,           // Unknown or closed
+    DC_EDGE_LOOP,             // Open self-loop (never affects connectivity)
+    DC_EDGE_TREE,
+    DC_EDGE_NONTREE
+};
+
+typedef struct DCEdge {
+    int u, v;
+    int level;
+    enum DCEdgeState state;
+    int slot[2];              // Non-tree: positions in u's and v's lists
+    ETNode** arcs;            // Tree: arcs[2 * i], arcs[2 * i + 1] in F_i
+    int arcCapacity;
+} DCEdge;
+
+typedef struct DynamicConnectivity {
+    int numVertices;
+    int vertexCapacity;
+    ETNode** levels[DC_MAX_LEVELS];   // levels[i][v]: v's node in F_i (NULL while v is alone)
+    DCEdge* edges;                    // Indexed by road id
+    int edgeCapacity;
+    int treeEdges;                    // Roads in F_0
+    Arena nodeArena;                  // Every ET node
+    ETNode* freeNodes;                // Recycled arcs
+    unsigned long long rng;
+} DynamicConnectivity;
+
+// Function to recompute a node's size and flags from its children
+static inline void etUpdate(ETNode* node) {
+    node->size = 1;
+    node->subtreeFlags = node->flags;
+    if (node->left) {
+        node->size += node->left->size;
+        node->subtreeFlags |= node->left->subtreeFlags;
+        node->left->parent = node;
+    }
+    if (node->right) {
+        node->size += node->right->size;
+        node->subtreeFlags |= node->right->subtreeFlags;
+        node->right->parent = node;
+    }
+}
+
+// Function to concatenate two tours
+static ETNode* etMerge(ETNode* a, ETNode* b) {
+    if (!a) return b;
+    if (!b) return a;
+    if (a->priority > b->priority) {
+        a->right = etMerge(a->right, b);
+        etUpdate(a);
+        return a;
+    }
+    b->left = etMerge(a, b->left);
+    etUpdate(b);
+    return b;
+}
+
+// Function to split a tour into its first k nodes and the rest
+static void etSplit(ETNode* node, int k, ETNode** first, ETNode** rest) {
+    if (!node) {
+        *first = *rest = NULL;
+        return;
+    }
+    node->parent = NULL;
+    int leftSize = node->left ? node->left->size : 0;
+    if (k <= leftSize) {
+        etSplit(node->left, k, first, &node->left);
+        etUpdate(node);
+        *rest = node;
+    } else {
+        etSplit(node->right, k - leftSize - 1, &node->right, rest);
+        etUpdate(node);
+        *first = node;
+    }
+    if (*first) (*first)->parent = NULL;
+    if (*rest) (*rest)->parent = NULL;
+}
+
+static ETNode* etRoot(ETNode* node) {
+    while (node->parent) node = node->parent;
+    return node;
+}
+
+// Function to return a node's position in its tour
+static int etPosition(ETNode* node) {
+    int position = node->left ? node->left->size : 0;
+    for (; node->parent; node = node->parent) {
+        if (node == node->parent->right) {
+            position += 1 + (node->parent->left ? node->parent->left->size : 0);
+        }
+    }
+    return position;
+}
+
+// Function to refresh the aggregates above a node whose flags changed
+static void etRefresh(ETNode* node) {
+    for (; node; node = node->parent) etUpdate(node);
+}
+
+// Function to rotate a tour so it starts at the given vertex node
+static ETNode* etReroot(ETNode* vertexNode) {
+    ETNode* root = etRoot(vertexNode);
+    ETNode *before, *after;
+    etSplit(root, etPosition(vertexNode), &before, &after);
+    return etMerge(after, before);
+}
+
+static ETNode* dcNewNode(DynamicConnectivity* dc, int vertex, int edge) {
+    ETNode* node = dc->freeNodes;
+    if (node) {
+        dc->freeNodes = node->right;
+    } else {
+        node = (ETNode*)arenaAlloc(&dc->nodeArena, sizeof(ETNode), _Alignof(ETNode));
+    }
+    memset(node, 0, sizeof(ETNode));
+    dc->rng ^= dc->rng << 13;
+    dc->rng ^= dc->rng >> 7;
+    dc->rng ^= dc->rng << 17;
+    node->priority = (unsigned)dc->rng;
+    node->size = 1;
+    node->vertex = vertex;
+    node->edge = edge;
+    return node;
+}
+
+// Function to return v's node in F_level, creating it (and the level) on first use
+static ETNode* dcVertexNode(DynamicConnectivity* dc, int level, int v) {
+    if (dc->levels[level] == NULL) {
+        dc->levels[level] = (ETNode**)calloc((size_t)dc->vertexCapacity, sizeof(ETNode*));
+    }
+    if (dc->levels[level][v] == NULL) dc->levels[level][v] = dcNewNode(dc, v, -1);
+    return dc->levels[level][v];
+}
+
+// Function to initialize the structure for numVertices isolated vertices
+void dcInit(DynamicConnectivity* dc, int numVertices) {
+    memset(dc, 0, sizeof(*dc));
+    dc->numVertices = numVertices;
+    dc->vertexCapacity = numVertices > 0 ? numVertices : 1;
+    arenaInit(&dc->nodeArena, 0);
+    dc->rng = 0x9E3779B97F4A7C15ULL;
+}
+
+// Function to add an isolated vertex (numbered numVertices)
+void dcAddVertex(DynamicConnectivity* dc) {
+    if (dc->numVertices == dc->vertexCapacity) {
+        int capacity = 2 * dc->vertexCapacity;
+        for (int level = 0; level < DC_MAX_LEVELS; level++) {
+            if (dc->levels[level] == NULL) continue;
+            dc->levels[level] = (ETNode**)realloc(dc->levels[level], (size_t)capacity * sizeof(ETNode*));
+            memset(dc->levels[level] + dc->vertexCapacity, 0,
+                   (size_t)(capacity - dc->vertexCapacity) * sizeof(ETNode*));
+        }
+        dc->vertexCapacity = capacity;
+    }
+    dc->numVertices++;
+}
+
+// Function to free every level, list and node
+void dcFree(DynamicConnectivity* dc) {
+    for (int level = 0; level < DC_MAX_LEVELS; level++) {
+        if (dc->levels[level] == NULL) continue;
+        for (int v = 0; v < dc->numVertices; v++) {
+            if (dc->levels[level][v]) free(dc->levels[level][v]->nontree);
+        }
+        free(dc->levels[level]);
+        dc->levels[level] = NULL;
+    }
+    for (int e = 0; e < dc->edgeCapacity; e++) free(dc->edges[e].arcs);
+    free(dc->edges);
+    dc->edges = NULL;
+    dc->edgeCapacity = 0;
+    arenaRelease(&dc->nodeArena);
+    dc->freeNodes = NULL;
+    dc->treeEdges = 0;
+}
+
+// Function to check whether u and v are in the same tree of F_level
+static bool dcConnectedAtLevel(DynamicConnectivity* dc, int level, int u, int v) {
+    if (u == v) return true;
+    if (dc->levels[level] == NULL) return false;
+    ETNode* nu = dc->levels[level][u];
+    ETNode* nv = dc->levels[level][v];
+    return nu && nv && etRoot(nu) == etRoot(nv);
+}
+
+// Function to link the trees of a road's endpoints in F_level
+static void dcLink(DynamicConnectivity* dc, int level, int edgeId) {
+    DCEdge* edge = &dc->edges[edgeId];
+    if (edge->arcCapacity < 2 * (level + 1)) {
+        int capacity = 2 * (level + 1);
+        edge->arcs = (ETNode**)realloc(edge->arcs, (size_t)capacity * sizeof(ETNode*));
+        edge->arcCapacity = capacity;
+    }
+    ETNode* tourU = etReroot(dcVertexNode(dc, level, edge->u));
+    ETNode* tourV = etReroot(dcVertexNode(dc, level, edge->v));
+    ETNode* forward = dcNewNode(dc, -1, edgeId);
+    ETNode* backward = dcNewNode(dc, -1, edgeId);
+    if (edge->level == level) forward->flags = ET_TREE;
+    etUpdate(forward);
+    edge->arcs[2 * level] = forward;
+    edge->arcs[2 * level + 1] = backward;
+    etMerge(etMerge(etMerge(tourU, forward), tourV), backward);
+}
+
+// Function to cut a tree road out of F_level
+static void dcCut(DynamicConnectivity* dc, int level, int edgeId) {
+    DCEdge* edge = &dc->edges[edgeId];
+    ETNode* first = edge->arcs[2 * level];
+    ETNode* second = edge->arcs[2 * level + 1];
+    ETNode* root = etRoot(first);
+    int p1 = etPosition(first);
+    int p2 = etPosition(second);
+    if (p1 > p2) {
+        int t = p1;
+        p1 = p2;
+        p2 = t;
+    }
+    // Tour = A first B second C  ->  A C and B
+    ETNode *head, *tail, *a, *b, *c, *arc;
+    etSplit(root, p2, &head, &tail);
+    etSplit(tail, 1, &arc, &c);
+    arc->right = dc->freeNodes;
+    dc->freeNodes = arc;
+    etSplit(head, p1, &a, &tail);
+    etSplit(tail, 1, &arc, &b);
+    arc->right = dc->freeNodes;
+    dc->freeNodes = arc;
+    etMerge(a, c);
+    edge->arcs[2 * level] = edge->arcs[2 * level + 1] = NULL;
+}
+
+// Function to append a non-tree road to one endpoint's list at its level
+static void dcPushNontree(DynamicConnectivity* dc, int edgeId, int side) {
+    DCEdge* edge = &dc->edges[edgeId];
+    ETNode* node = dcVertexNode(dc, edge->level, side == 0 ? edge->u : edge->v);
+    if (node->nontreeCount == node->nontreeCapacity) {
+        node->nontreeCapacity = node->nontreeCapacity ? 2 * node->nontreeCapacity : 4;
+        node->nontree = (int*)realloc(node->nontree, (size_t)node->nontreeCapacity * sizeof(int));
+    }
+    edge->slot[side] = node->nontreeCount;
+    node->nontree[node->nontreeCount++] = edgeId;
+    if (!(node->flags & ET_NONTREE)) {
+        node->flags |= ET_NONTREE;
+        etRefresh(node);
+    }
+}
+
+// Function to remove a non-tree road from one endpoint's list (swap with the last)
+static void dcPopNontree(DynamicConnectivity* dc, int edgeId, int side) {
+    DCEdge* edge = &dc->edges[edgeId];
+    int vertex = side == 0 ? edge->u : edge->v;
+    ETNode* node = dc->levels[edge->level][vertex];
+    int slot = edge->slot[side];
+    int moved = node->nontree[--node->nontreeCount];
+    if (moved != edgeId) {
+        node->nontree[slot] = moved;
+        DCEdge* other = &dc->edges[moved];
+        other->slot[other->u == vertex ? 0 : 1] = slot;
+    }
+    if (node->nontreeCount == 0) {
+        node->flags &= (unsigned char)~ET_NONTREE;
+        etRefresh(node);
+    }
+}
+
+static void dcAddNontree(DynamicConnectivity* dc, int edgeId) {
+    dc->edges[edgeId].state = DC_EDGE_NONTREE;
+    dcPushNontree(dc, edgeId, 0);
+    dcPushNontree(dc, edgeId, 1);
+}
+
+static void dcRemoveNontree(DynamicConnectivity* dc, int edgeId) {
+    dcPopNontree(dc, edgeId, 0);
+    dcPopNontree(dc, edgeId, 1);
+}
+
+// Function to find a node in the subtree whose own flags contain flag
+static ETNode* etFindFlag(ETNode* node, unsigned char flag) {
+    while (!(node->flags & flag)) {
+        node = (node->left && (node->left->subtreeFlags & flag)) ? node->left : node->right;
+    }
+    return node;
+}
+
+// Function to look for a road reconnecting u's and v's trees at one level
+// Scans the smaller tree: its level-i tree roads move up to level i + 1, then
+// each level-i non-tree road either reconnects the halves or moves up too.
+static bool dcReplace(DynamicConnectivity* dc, int level, int u, int v) {
+    ETNode* rootU = etRoot(dcVertexNode(dc, level, u));
+    ETNode* rootV = etRoot(dcVertexNode(dc, level, v));
+    ETNode* small = rootU->size <= rootV->size ? rootU : rootV;
+    
+    while (small->subtreeFlags & ET_TREE) {
+        ETNode* arc = etFindFlag(small, ET_TREE);
+        arc->flags &= (unsigned char)~ET_TREE;
+        etRefresh(arc);
+        dc->edges[arc->edge].level = level + 1;
+        dcLink(dc, level + 1, arc->edge);
+    }
+    
+    while (small->subtreeFlags & ET_NONTREE) {
+        ETNode* node = etFindFlag(small, ET_NONTREE);
+        int edgeId = node->nontree[node->nontreeCount - 1];
+        DCEdge* edge = &dc->edges[edgeId];
+        int other = edge->u == node->vertex ? edge->v : edge->u;
+        dcRemoveNontree(dc, edgeId);
+        if (etRoot(dc->levels[level][other]) != small) {
+            // Replacement found: it becomes a tree road of F_0..F_level
+            edge->state = DC_EDGE_TREE;
+            for (int i = 0; i <= level; i++) dcLink(dc, i, edgeId);
+            dc->treeEdges++;
+            return true;
+        }
+        edge->level = level + 1;
+        dcAddNontree(dc, edgeId);
+    }
+    return false;
+}
+
+// Function to open road edgeId between u and v
+void dcInsertEdge(DynamicConnectivity* dc, int edgeId, int u, int v) {
+    if (edgeId >= dc->edgeCapacity) {
+        int capacity = dc->edgeCapacity ? dc->edgeCapacity : 64;
+        while (capacity <= edgeId) capacity *= 2;
+        dc->edges = (DCEdge*)realloc(dc->edges, (size_t)capacity * sizeof(DCEdge));
+        memset(dc->edges + dc->edgeCapacity, 0, (size_t)(capacity - dc->edgeCapacity) * sizeof(DCEdge));
+        dc->edgeCapacity = capacity;
+    }
+    DCEdge* edge = &dc->edges[edgeId];
+    if (edge->state != DC_EDGE_ABSENT) return;
+    edge->u = u;
+    edge->v = v;
+    edge->level = 0;
+    
+    if (u == v) {
+        edge->state = DC_EDGE_LOOP;
+    } else if (!dcConnectedAtLevel(dc, 0, u, v)) {
+        edge->state = DC_EDGE_TREE;
+        dcLink(dc, 0, edgeId);
+        dc->treeEdges++;
+    } else {
+        dcAddNontree(dc, edgeId);
+    }
+}
+
+// Function to close road edgeId
+void dcDeleteEdge(DynamicConnectivity* dc, int edgeId) {
+    if (edgeId >= dc->edgeCapacity) return;
+    DCEdge* edge = &dc->edges[edgeId];
+    enum DCEdgeState state = edge->state;
+    edge->state = DC_EDGE_ABSENT;
+    
+    if (state == DC_EDGE_NONTREE) {
+        dcRemoveNontree(dc, edgeId);
+    } else if (state == DC_EDGE_TREE) {
+        for (int i = 0; i <= edge->level; i++) dcCut(dc, i, edgeId);
+        dc->treeEdges--;
+        for (int i = edge->level; i >= 0; i--) {
+            if (dcReplace(dc, i, edge->u, edge->v)) break;
+        }
+    }
+}
+
+// Function to check whether two intersections are connected by open roads
+bool dcConnected(DynamicConnectivity* dc, int u, int v) {
+    return dcConnectedAtLevel(dc, 0, u, v);
+}
+
+// Function to return the number of connected components
+int dcComponentCount(const DynamicConnectivity* dc) {
+    return dc->numVertices - dc->treeEdges;
+}
 
 // Structure for adjacency list node (represents a road)
 typedef struct Road {
@@ -21,25 +452,155 @@ typedef struct Intersection {
     Road* roads;          // List of connected roads
 } Intersection;
 
+// Compressed (CSR) copy of the road lists used by the traversals: the roads
+// of intersection v are targets[offsets[v] .. offsets[v + 1]), in the same
+// order as its Road list. Rebuilt lazily after addRoad; blocking a road only
+// flips its bit in blockedRoads, which the traversals read through roadIds.
+typedef struct RoadCSR {
+    int numVertices;
+    int numRoads;         // city->numRoads when it was built
+    int* offsets;
+    int* targets;
+    int* roadIds;
+} RoadCSR;
+
+// Function to free the CSR copy
+void freeAdjacency(RoadCSR* csr) {
+    free(csr->offsets);
+    free(csr->targets);
+    free(csr->roadIds);
+    memset(csr, 0, sizeof(*csr));
+}
+
+// ===================== ROAD STATUS AND LOOKUP =====================
+
+// Packed bitset (one bit per road id) that grows with the road count
+typedef struct PackedBitset {
+    uint64_t* words;
+    size_t numWords;
+} PackedBitset;
+
+static inline bool bitTest(const uint64_t* bits, int v) {
+    return (bits[v >> 6] >> (v & 63)) & 1;
+}
+
+static inline void bitSet(uint64_t* bits, int v) {
+    bits[v >> 6] |= 1ULL << (v & 63);
+}
+
+static inline void bitClear(uint64_t* bits, int v) {
+    bits[v >> 6] &= ~(1ULL << (v & 63));
+}
+
+// Function to make room for numBits bits (new bits start cleared)
+void bitsetReserve(PackedBitset* set, size_t numBits) {
+    size_t needed = numBits / 64 + 1;
+    if (needed <= set->numWords) return;
+    size_t words = set->numWords ? set->numWords : 16;
+    while (words < needed) words *= 2;
+    set->words = (uint64_t*)realloc(set->words, words * sizeof(uint64_t));
+    memset(set->words + set->numWords, 0, (words - set->numWords) * sizeof(uint64_t));
+    set->numWords = words;
+}
+
+// Flat open-addressing hash table from an unordered intersection pair to
+// the id of the most recently added road between them (linear probing,
+// power-of-two capacity, at most half full). Roads are never removed, so
+// there are no tombstones and a lookup is one or two cache lines.
+typedef struct RoadIndex {
+    uint64_t* keys;             // Packed pair + 1 (0 marks an empty slot)
+    int* roadIds;
+    size_t capacity;
+    size_t count;
+} RoadIndex;
+
+static inline uint64_t roadKey(int intersection1, int intersection2) {
+    uint32_t low = (uint32_t)(intersection1 < intersection2 ? intersection1 : intersection2);
+    uint32_t high = (uint32_t)(intersection1 < intersection2 ? intersection2 : intersection1);
+    return (((uint64_t)low << 32) | high) + 1;
+}
+
+static inline size_t roadSlot(uint64_t key, size_t capacity) {
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    return (size_t)key & (capacity - 1);
+}
+
+// Function to record roadId as the road between two intersections
+void roadIndexPut(RoadIndex* index, int intersection1, int intersection2, int roadId) {
+    if (2 * (index->count + 1) > index->capacity) {
+        size_t oldCapacity = index->capacity;
+        uint64_t* oldKeys = index->keys;
+        int* oldIds = index->roadIds;
+        index->capacity = oldCapacity ? 2 * oldCapacity : 64;
+        index->keys = (uint64_t*)calloc(index->capacity, sizeof(uint64_t));
+        index->roadIds = (int*)malloc(index->capacity * sizeof(int));
+        for (size_t i = 0; i < oldCapacity; i++) {
+            if (oldKeys[i] == 0) continue;
+            size_t slot = roadSlot(oldKeys[i], index->capacity);
+            while (index->keys[slot] != 0) slot = (slot + 1) & (index->capacity - 1);
+            index->keys[slot] = oldKeys[i];
+            index->roadIds[slot] = oldIds[i];
+        }
+        free(oldKeys);
+        free(oldIds);
+    }
+    
+    uint64_t key = roadKey(intersection1, intersection2);
+    size_t slot = roadSlot(key, index->capacity);
+    while (index->keys[slot] != 0 && index->keys[slot] != key) slot = (slot + 1) & (index->capacity - 1);
+    if (index->keys[slot] == 0) {
+        index->keys[slot] = key;
+        index->count++;
+    }
+    index->roadIds[slot] = roadId;
+}
+
+// Function to look up the road between two intersections (-1 if none)
+int roadIndexGet(const RoadIndex* index, int intersection1, int intersection2) {
+    if (index->capacity == 0) return -1;
+    uint64_t key = roadKey(intersection1, intersection2);
+    size_t slot = roadSlot(key, index->capacity);
+    while (index->keys[slot] != 0) {
+        if (index->keys[slot] == key) return index->roadIds[slot];
+        slot = (slot + 1) & (index->capacity - 1);
+    }
+    return -1;
+}
+
+void roadIndexFree(RoadIndex* index) {
+    free(index->keys);
+    free(index->roadIds);
+    memset(index, 0, sizeof(*index));
+}
+
+// Component label of every intersection, valid for one road status epoch
+typedef struct ComponentLabels {
+    int* label;
+    int capacity;
+    int numComponents;
+    unsigned long long epoch;     // roadStatusEpoch the labels were computed in
+} ComponentLabels;
+
 // Structure for the city graph
 typedef struct CityGraph {
     int numIntersections;
     int numRoads;
-    Intersection intersections[MAX_INTERSECTIONS];
-    bool roadBlocked[MAX_ROADS];  // Global road blocking status
+    int intersectionCapacity;
+    Intersection* intersections;  // Grows with addIntersection
+    PackedBitset blockedRoads;    // Global road blocking status, one bit per road id
+    RoadIndex roadIndex;          // Intersection pair -> road id, for block/unblock
+    Arena roadArena;              // Storage for every Road node, released by freeCityGraph
+    DynamicConnectivity connectivity;  // Open roads, kept up to date by add/block/unblock
+    RoadCSR adjacency;            // Traversal copy of the roads (see cityAdjacency)
+    unsigned long long roadStatusEpoch;  // Bumped by every change to roads or their status
+    ComponentLabels labels;       // Cached per epoch (see componentLabels)
 } CityGraph;
 
-// Queue structure for BFS
-typedef struct Queue {
-    int items[MAX_INTERSECTIONS];
-    int front;
-    int rear;
-    int size;
-} Queue;
-
-// Function to create a new road
-Road* createRoad(int destination, int roadId) {
-    Road* newRoad = (Road*)malloc(sizeof(Road));
+// Function to create a new road in the city's road arena
+Road* createRoad(Arena* arena, int destination, int roadId) {
+    Road* newRoad = (Road*)arenaAlloc(arena, sizeof(Road), _Alignof(Road));
     newRoad->destination = destination;
     newRoad->roadId = roadId;
     newRoad->isBlocked = false;
@@ -47,19 +608,62 @@ Road* createRoad(int destination, int roadId) {
     return newRoad;
 }
 
+// Function to check whether a road is blocked
+static inline bool isRoadBlocked(const CityGraph* city, int roadId) {
+    return bitTest(city->blockedRoads.words, roadId);
+}
+
 // Function to initialize the city graph
 void initializeCityGraph(CityGraph* city, int numIntersections) {
     city->numIntersections = numIntersections;
     city->numRoads = 0;
+    city->intersectionCapacity = numIntersections > 0 ? numIntersections : 1;
+    city->intersections = (Intersection*)malloc((size_t)city->intersectionCapacity * sizeof(Intersection));
+    arenaInit(&city->roadArena, 0);
     
     for (int i = 0; i < numIntersections; i++) {
         city->intersections[i].id = i;
         city->intersections[i].roads = NULL;
     }
     
-    for (int i = 0; i < MAX_ROADS; i++) {
-        city->roadBlocked[i] = false;
+    memset(&city->blockedRoads, 0, sizeof(city->blockedRoads));
+    bitsetReserve(&city->blockedRoads, 0);
+    memset(&city->roadIndex, 0, sizeof(city->roadIndex));
+    dcInit(&city->connectivity, numIntersections);
+    memset(&city->adjacency, 0, sizeof(city->adjacency));
+    city->roadStatusEpoch = 0;
+    memset(&city->labels, 0, sizeof(city->labels));
+}
+
+// Function to release every road and intersection of the city graph at once
+void freeCityGraph(CityGraph* city) {
+    arenaRelease(&city->roadArena);
+    free(city->intersections);
+    city->intersections = NULL;
+    city->numIntersections = city->intersectionCapacity = 0;
+    city->numRoads = 0;
+    free(city->blockedRoads.words);
+    memset(&city->blockedRoads, 0, sizeof(city->blockedRoads));
+    roadIndexFree(&city->roadIndex);
+    dcFree(&city->connectivity);
+    freeAdjacency(&city->adjacency);
+    free(city->labels.label);
+    memset(&city->labels, 0, sizeof(city->labels));
+}
+
+// Function to add an intersection with no roads; returns its id
+int addIntersection(CityGraph* city) {
+    if (city->numIntersections == city->intersectionCapacity) {
+        city->intersectionCapacity *= 2;
+        city->intersections = (Intersection*)realloc(city->intersections,
+                                                     (size_t)city->intersectionCapacity * sizeof(Intersection));
     }
+    int id = city->numIntersections++;
+    city->intersections[id].id = id;
+    city->intersections[id].roads = NULL;
+    dcAddVertex(&city->connectivity);
+    city->roadStatusEpoch++;
+    return id;
 }
 
 // Function to add a road (undirected edge)
@@ -67,80 +671,616 @@ void addRoad(CityGraph* city, int intersection1, int intersection2) {
     int roadId = city->numRoads++;
     
     // Add road from intersection1 to intersection2
-    Road* road1 = createRoad(intersection2, roadId);
+    Road* road1 = createRoad(&city->roadArena, intersection2, roadId);
     road1->next = city->intersections[intersection1].roads;
     city->intersections[intersection1].roads = road1;
     
     // Add road from intersection2 to intersection1 (undirected)
-    Road* road2 = createRoad(intersection1, roadId);
+    Road* road2 = createRoad(&city->roadArena, intersection1, roadId);
     road2->next = city->intersections[intersection2].roads;
     city->intersections[intersection2].roads = road2;
     
-    printf("Road %d added between intersections %d and %d\n", roadId, intersection1, intersection2);
+    bitsetReserve(&city->blockedRoads, (size_t)roadId + 1);
+    roadIndexPut(&city->roadIndex, intersection1, intersection2, roadId);
+    dcInsertEdge(&city->connectivity, roadId, intersection1, intersection2);
+    city->roadStatusEpoch++;
+    
+    CITY_LOG("Road %d added between intersections %d and %d\n", roadId, intersection1, intersection2);
+}
+
+// Function to find the id of the road between two intersections (-1 if none)
+// O(1) through the road index, whatever the degree of the intersections;
+// with several roads between them, the most recently added one is found.
+int findRoadId(CityGraph* city, int intersection1, int intersection2) {
+    return roadIndexGet(&city->roadIndex, intersection1, intersection2);
 }
 
 // Function to block a road
 void blockRoad(CityGraph* city, int intersection1, int intersection2) {
     // Find and block the road between intersection1 and intersection2
-    Road* current = city->intersections[intersection1].roads;
+    int roadId = findRoadId(city, intersection1, intersection2);
     
-    while (current != NULL) {
-        if (current->destination == intersection2) {
-            city->roadBlocked[current->roadId] = true;
-            printf("Road %d between intersections %d and %d has been blocked\n", 
-                   current->roadId, intersection1, intersection2);
-            return;
-        }
-        current = current->next;
+    if (roadId < 0) {
+        CITY_LOG("Road between intersections %d and %d not found\n", intersection1, intersection2);
+        return;
     }
-    
-    printf("Road between intersections %d and %d not found\n", intersection1, intersection2);
+    if (!isRoadBlocked(city, roadId)) {
+        bitSet(city->blockedRoads.words, roadId);
+        city->roadStatusEpoch++;
+        dcDeleteEdge(&city->connectivity, roadId);
+    }
+    CITY_LOG("Road %d between intersections %d and %d has been blocked\n", 
+           roadId, intersection1, intersection2);
 }
 
 // Function to unblock a road
 void unblockRoad(CityGraph* city, int intersection1, int intersection2) {
-    Road* current = city->intersections[intersection1].roads;
+    int roadId = findRoadId(city, intersection1, intersection2);
+    
+    if (roadId < 0) {
+        CITY_LOG("Road between intersections %d and %d not found\n", intersection1, intersection2);
+        return;
+    }
+    if (isRoadBlocked(city, roadId)) {
+        bitClear(city->blockedRoads.words, roadId);
+        city->roadStatusEpoch++;
+        dcInsertEdge(&city->connectivity, roadId, intersection1, intersection2);
+    }
+    CITY_LOG("Road %d between intersections %d and %d has been unblocked\n", 
+           roadId, intersection1, intersection2);
+}
+
+// Function to check reachability with the dynamic connectivity index
+// O(log n) per query, no traversal; kept current by addRoad/blockRoad/unblockRoad.
+bool isReachableIndexed(CityGraph* city, int start, int end) {
+    return dcConnected(&city->connectivity, start, end);
+}
+
+// Function to count connected components with the dynamic connectivity index
+int countComponentsIndexed(CityGraph* city) {
+    return dcComponentCount(&city->connectivity);
+}
+
+// ===================== OFFLINE CLOSURE REPLAY =====================
+//
+// Replays a whole day of closures at once: every road is open during a set
+// of time intervals, each interval is stored on O(log T) nodes of a segment
+// tree over the event times, and a depth-first walk of that tree unions the
+// roads of each node into a union-find with rollback (union by size, no path
+// compression) and undoes them on the way back. Each query is answered at
+// its leaf in O(log n): O((T + R) log T log n) for T events and R roads.
+
+enum ClosureEventType {
+    EVENT_BLOCK,                // Close the road between a and b
+    EVENT_UNBLOCK,              // Reopen the road between a and b
+    EVENT_QUERY_REACHABLE,      // Answer 1 if a and b are connected, 0 if not
+    EVENT_QUERY_COMPONENTS      // Answer the number of connected components
+};
+
+typedef struct ClosureEvent {
+    enum ClosureEventType type;
+    int a, b;
+} ClosureEvent;
+
+// Union-find with an undo log
+typedef struct RollbackDSU {
+    int* parent;
+    int* size;
+    int* history;               // Roots attached below another root, in order
+    int historyCount;
+    int components;
+} RollbackDSU;
+
+static int rollbackFind(const RollbackDSU* dsu, int x) {
+    while (dsu->parent[x] != x) x = dsu->parent[x];
+    return x;
+}
+
+static void rollbackUnion(RollbackDSU* dsu, int a, int b) {
+    a = rollbackFind(dsu, a);
+    b = rollbackFind(dsu, b);
+    if (a == b) return;
+    if (dsu->size[a] < dsu->size[b]) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+    dsu->parent[b] = a;
+    dsu->size[a] += dsu->size[b];
+    dsu->history[dsu->historyCount++] = b;
+    dsu->components--;
+}
+
+static void rollbackTo(RollbackDSU* dsu, int historyCount) {
+    while (dsu->historyCount > historyCount) {
+        int b = dsu->history[--dsu->historyCount];
+        int a = dsu->parent[b];
+        dsu->size[a] -= dsu->size[b];
+        dsu->parent[b] = b;
+        dsu->components++;
+    }
+}
+
+// Segment tree over event times; each node holds a linked list of roads
+typedef struct ReplayTree {
+    int* head;                  // Per node: first entry, -1 if none
+    int* next;                  // Per entry: next entry of the same node
+    int* road;                  // Per entry: road id
+    int count, capacity;
+} ReplayTree;
+
+static void replayAddInterval(ReplayTree* tree, int node, int lo, int hi, int from, int to, int roadId) {
+    if (to <= lo || hi <= from) return;
+    if (from <= lo && hi <= to) {
+        if (tree->count == tree->capacity) {
+            tree->capacity = tree->capacity ? 2 * tree->capacity : 64;
+            tree->next = (int*)realloc(tree->next, (size_t)tree->capacity * sizeof(int));
+            tree->road = (int*)realloc(tree->road, (size_t)tree->capacity * sizeof(int));
+        }
+        tree->road[tree->count] = roadId;
+        tree->next[tree->count] = tree->head[node];
+        tree->head[node] = tree->count++;
+        return;
+    }
+    int mid = (lo + hi) / 2;
+    replayAddInterval(tree, 2 * node, lo, mid, from, to, roadId);
+    replayAddInterval(tree, 2 * node + 1, mid, hi, from, to, roadId);
+}
+
+static void replayWalk(const ReplayTree* tree, const int* roadEnds, RollbackDSU* dsu, int node, int lo, int hi,
+                       const ClosureEvent* events, int* answers) {
+    int saved = dsu->historyCount;
+    for (int entry = tree->head[node]; entry != -1; entry = tree->next[entry]) {
+        int roadId = tree->road[entry];
+        rollbackUnion(dsu, roadEnds[2 * roadId], roadEnds[2 * roadId + 1]);
+    }
+    
+    if (hi - lo == 1) {
+        const ClosureEvent* event = &events[lo];
+        if (answers[lo] < 0) {
+            // Not a query, or one with an endpoint outside the city
+        } else if (event->type == EVENT_QUERY_REACHABLE) {
+            answers[lo] = rollbackFind(dsu, event->a) == rollbackFind(dsu, event->b);
+        } else if (event->type == EVENT_QUERY_COMPONENTS) {
+            answers[lo] = dsu->components;
+        }
+    } else {
+        int mid = (lo + hi) / 2;
+        replayWalk(tree, roadEnds, dsu, 2 * node, lo, mid, events, answers);
+        replayWalk(tree, roadEnds, dsu, 2 * node + 1, mid, hi, events, answers);
+    }
+    rollbackTo(dsu, saved);
+}
+
+// Function to replay a sequence of closures and queries offline, starting
+// from the city's current road status (the city itself is not modified)
+// answers[t] receives the answer of each query event and -1 for the others,
+// including reachability queries naming an intersection outside the city
+// (block/unblock events for unknown roads are skipped the same way).
+// Returns the number of queries answered.
+int replayClosuresOffline(CityGraph* city, const ClosureEvent* events, int numEvents, int* answers) {
+    if (numEvents <= 0) return 0;
+    int numRoads = city->numRoads;
+    int* roadEnds = (int*)malloc((size_t)(2 * numRoads + 1) * sizeof(int));
+    int* openSince = (int*)malloc((size_t)(numRoads + 1) * sizeof(int));
+    for (int i = 0; i < city->numIntersections; i++) {
+        for (Road* road = city->intersections[i].roads; road != NULL; road = road->next) {
+            roadEnds[2 * road->roadId] = i;
+            roadEnds[2 * road->roadId + 1] = road->destination;
+        }
+    }
+    
+    ReplayTree tree = {NULL, NULL, NULL, 0, 0};
+    tree.head = (int*)malloc((size_t)(4 * numEvents) * sizeof(int));
+    for (int i = 0; i < 4 * numEvents; i++) tree.head[i] = -1;
+    
+    // A road is open from openSince[id] until the event that blocks it
+    for (int id = 0; id < numRoads; id++) openSince[id] = isRoadBlocked(city, id) ? -1 : 0;
+    int queries = 0;
+    for (int t = 0; t < numEvents; t++) {
+        answers[t] = -1;
+        const ClosureEvent* event = &events[t];
+        if (event->type == EVENT_QUERY_REACHABLE) {
+            if (event->a >= 0 && event->a < city->numIntersections &&
+                event->b >= 0 && event->b < city->numIntersections) {
+                answers[t] = 0;   // Answered by the walk below
+                queries++;
+            }
+            continue;
+        }
+        if (event->type == EVENT_QUERY_COMPONENTS) {
+            answers[t] = 0;
+            queries++;
+            continue;
+        }
+        int id = findRoadId(city, event->a, event->b);
+        if (id < 0) continue;
+        if (event->type == EVENT_BLOCK && openSince[id] >= 0) {
+            replayAddInterval(&tree, 1, 0, numEvents, openSince[id], t, id);
+            openSince[id] = -1;
+        } else if (event->type == EVENT_UNBLOCK && openSince[id] < 0) {
+            openSince[id] = t + 1;
+        }
+    }
+    for (int id = 0; id < numRoads; id++) {
+        if (openSince[id] >= 0) replayAddInterval(&tree, 1, 0, numEvents, openSince[id], numEvents, id);
+    }
+    
+    RollbackDSU dsu;
+    int n = city->numIntersections;
+    dsu.parent = (int*)malloc((size_t)n * sizeof(int));
+    dsu.size = (int*)malloc((size_t)n * sizeof(int));
+    dsu.history = (int*)malloc((size_t)n * sizeof(int));
+    dsu.historyCount = 0;
+    dsu.components = n;
+    for (int i = 0; i < n; i++) {
+        dsu.parent[i] = i;
+        dsu.size[i] = 1;
+    }
+    replayWalk(&tree, roadEnds, &dsu, 1, 0, numEvents, events, answers);
+    
+    free(dsu.parent);
+    free(dsu.size);
+    free(dsu.history);
+    free(tree.head);
+    free(tree.next);
+    free(tree.road);
+    free(roadEnds);
+    free(openSince);
+    return queries;
+}
+
+// ===================== TRAVERSAL ENGINE =====================
+//
+// The BFS queries run level by level over the CSR copy of the roads. Each
+// level is one of
+//   top-down:  scan the roads of every frontier intersection and claim its
+//              unvisited neighbors
+//   bottom-up: scan every unvisited intersection for an open road back into
+//              the frontier, stopping at the first one (Beamer et al.)
+// Bottom-up wins once the frontier's road ends outnumber the unexplored
+// ones by TRAVERSAL_ALPHA, and top-down comes back once the frontier drops
+// below n / TRAVERSAL_BETA intersections. Visited sets are bitmaps, the
+// frontier is a slice of the growable visit order (each level appends the
+// next one), and levels with enough work are split across threads.
+//
+// On small cities every level is a sequential top-down step, which visits
+// intersections in exactly the order of a queue-based BFS.
+
+#define TRAVERSAL_ALPHA 14
+#define TRAVERSAL_BETA 24
+#ifndef TRAVERSAL_DIRECTION_MIN
+#define TRAVERSAL_DIRECTION_MIN 1024   // Smaller cities always search top-down
+#endif
+#ifndef TRAVERSAL_PARALLEL_MIN
+#define TRAVERSAL_PARALLEL_MIN 16384   // Road ends (or intersections) before a level goes parallel
+#endif
+
+static int traversalThreads = 0;        // 0 = one per CPU (resolved on first use)
+
+// Function to return the CSR copy of the roads, rebuilding it if roads
+// were added since it was built
+const RoadCSR* cityAdjacency(CityGraph* city) {
+    RoadCSR* csr = &city->adjacency;
+    if (csr->offsets != NULL && csr->numRoads == city->numRoads && csr->numVertices == city->numIntersections) {
+        return csr;
+    }
     
-    while (current != NULL) {
-        if (current->destination == intersection2) {
-            city->roadBlocked[current->roadId] = false;
-            printf("Road %d between intersections %d and %d has been unblocked\n", 
-                   current->roadId, intersection1, intersection2);
-            return;
+    int n = city->numIntersections;
+    free(csr->offsets);
+    free(csr->targets);
+    free(csr->roadIds);
+    csr->numVertices = n;
+    csr->numRoads = city->numRoads;
+    csr->offsets = (int*)calloc((size_t)n + 1, sizeof(int));
+    for (int i = 0; i < n; i++) {
+        for (Road* road = city->intersections[i].roads; road != NULL; road = road->next) {
+            csr->offsets[i + 1]++;
         }
-        current = current->next;
     }
+    for (int i = 0; i < n; i++) csr->offsets[i + 1] += csr->offsets[i];
     
-    printf("Road between intersections %d and %d not found\n", intersection1, intersection2);
+    // Keep each intersection's roads in Road-list order
+    csr->targets = (int*)malloc((size_t)csr->offsets[n] * sizeof(int) + 1);
+    csr->roadIds = (int*)malloc((size_t)csr->offsets[n] * sizeof(int) + 1);
+    for (int i = 0; i < n; i++) {
+        int slot = csr->offsets[i];
+        for (Road* road = city->intersections[i].roads; road != NULL; road = road->next) {
+            csr->targets[slot] = road->destination;
+            csr->roadIds[slot] = road->roadId;
+            slot++;
+        }
+    }
+    return csr;
 }
 
-// Queue operations for BFS
-void initializeQueue(Queue* queue) {
-    queue->front = 0;
-    queue->rear = -1;
-    queue->size = 0;
+// State of one or more BFS runs over a city (the visited set is shared
+// between runs, which is how the component count covers every intersection)
+typedef struct Traversal {
+    const RoadCSR* graph;
+    const uint64_t* blockedRoads;
+    int numVertices;
+    uint64_t* visited;          // Bitmap of visited intersections
+    uint64_t* frontierBits;     // Bottom-up steps: the current frontier as a bitmap
+    int* parent;                // BFS tree (-1 at the source)
+    int* order;                 // Visit order of the last run; level after level
+    int orderCount;
+    int orderCapacity;
+    long long unexploredRoads;  // Road ends of intersections not yet visited
+    int numThreads;
+    int bottomUpLevels;         // Statistics of the last run
+    int parallelLevels;
+} Traversal;
+
+static inline int roadCount(const RoadCSR* graph, int v) {
+    return graph->offsets[v + 1] - graph->offsets[v];
 }
 
-bool isQueueEmpty(Queue* queue) {
-    return queue->size == 0;
+// Function to prepare a traversal of the city's open roads
+void traversalInit(Traversal* t, CityGraph* city) {
+    t->graph = cityAdjacency(city);
+    t->blockedRoads = city->blockedRoads.words;
+    t->numVertices = city->numIntersections;
+    
+    // Both bitmaps and the parent array share one zeroed block
+    size_t words = ((size_t)t->numVertices + 63) / 64 + 1;
+    t->visited = (uint64_t*)calloc(2 * words * sizeof(uint64_t) + ((size_t)t->numVertices + 1) * sizeof(int), 1);
+    t->frontierBits = t->visited + words;
+    t->parent = (int*)(t->frontierBits + words);
+    t->orderCapacity = 64;
+    t->order = (int*)malloc((size_t)t->orderCapacity * sizeof(int));
+    t->orderCount = 0;
+    t->unexploredRoads = t->graph->offsets[t->numVertices];
+    if (traversalThreads <= 0) traversalThreads = defaultThreadCount();
+    t->numThreads = traversalThreads;
+    t->bottomUpLevels = 0;
+    t->parallelLevels = 0;
 }
 
-void enqueue(Queue* queue, int item) {
-    if (queue->size < MAX_INTERSECTIONS) {
-        queue->rear = (queue->rear + 1) % MAX_INTERSECTIONS;
-        queue->items[queue->rear] = item;
-        queue->size++;
+void traversalFree(Traversal* t) {
+    free(t->visited);
+    free(t->order);
+}
+
+// Function to append intersections to the visit order, growing it as needed
+static void traversalAppend(Traversal* t, const int* items, int count) {
+    if (count == 0) return;
+    if (t->orderCount + count > t->orderCapacity) {
+        while (t->orderCount + count > t->orderCapacity) t->orderCapacity *= 2;
+        t->order = (int*)realloc(t->order, (size_t)t->orderCapacity * sizeof(int));
     }
+    memcpy(t->order + t->orderCount, items, (size_t)count * sizeof(int));
+    t->orderCount += count;
 }
 
-int dequeue(Queue* queue) {
-    if (!isQueueEmpty(queue)) {
-        int item = queue->items[queue->front];
-        queue->front = (queue->front + 1) % MAX_INTERSECTIONS;
-        queue->size--;
-        return item;
+// One level of a parallel traversal: the frontier is order[begin, end)
+typedef struct TraversalLevel {
+    Traversal* t;
+    int begin, end;
+    int** found;                // Per thread: intersections discovered
+    int* foundCount;
+    long long* foundRoads;      // Per thread: road ends of those intersections
+} TraversalLevel;
+
+static void levelPush(TraversalLevel* level, int threadId, int* capacity, int v) {
+    if (level->foundCount[threadId] == *capacity) {
+        *capacity = *capacity ? 2 * *capacity : 256;
+        level->found[threadId] = (int*)realloc(level->found[threadId], (size_t)*capacity * sizeof(int));
+    }
+    level->found[threadId][level->foundCount[threadId]++] = v;
+    level->foundRoads[threadId] += roadCount(level->t->graph, v);
+}
+
+// Top-down step over a share of the frontier; neighbors are claimed with an
+// atomic OR on the visited bitmap so each is discovered exactly once
+static void topDownTask(int threadId, int numThreads, void* arg) {
+    TraversalLevel* level = (TraversalLevel*)arg;
+    Traversal* t = level->t;
+    const RoadCSR* graph = t->graph;
+    int size = level->end - level->begin;
+    int begin = level->begin + (int)((long long)size * threadId / numThreads);
+    int end = level->begin + (int)((long long)size * (threadId + 1) / numThreads);
+    int capacity = 0;
+    
+    for (int i = begin; i < end; i++) {
+        int u = t->order[i];
+        for (int e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+            if (bitTest(t->blockedRoads, graph->roadIds[e])) continue;
+            int v = graph->targets[e];
+            uint64_t bit = 1ULL << (v & 63);
+            if (__atomic_load_n(&t->visited[v >> 6], __ATOMIC_RELAXED) & bit) continue;
+            if (__atomic_fetch_or(&t->visited[v >> 6], bit, __ATOMIC_RELAXED) & bit) continue;
+            t->parent[v] = u;
+            levelPush(level, threadId, &capacity, v);
+        }
+    }
+}
+
+// Bottom-up step over a share of the intersections, split on 64-bit word
+// boundaries so every thread owns its words of the visited bitmap
+static void bottomUpTask(int threadId, int numThreads, void* arg) {
+    TraversalLevel* level = (TraversalLevel*)arg;
+    Traversal* t = level->t;
+    const RoadCSR* graph = t->graph;
+    int words = (t->numVertices + 63) / 64;
+    int firstWord = (int)((long long)words * threadId / numThreads);
+    int lastWord = (int)((long long)words * (threadId + 1) / numThreads);
+    int capacity = 0;
+    
+    for (int w = firstWord; w < lastWord; w++) {
+        uint64_t unvisited = ~t->visited[w];
+        if (w == words - 1 && (t->numVertices & 63)) unvisited &= (1ULL << (t->numVertices & 63)) - 1;
+        uint64_t discovered = 0;
+        while (unvisited) {
+            int v = w * 64 + __builtin_ctzll(unvisited);
+            unvisited &= unvisited - 1;
+            for (int e = graph->offsets[v]; e < graph->offsets[v + 1]; e++) {
+                if (!bitTest(t->blockedRoads, graph->roadIds[e]) && bitTest(t->frontierBits, graph->targets[e])) {
+                    t->parent[v] = graph->targets[e];
+                    discovered |= 1ULL << (v & 63);
+                    levelPush(level, threadId, &capacity, v);
+                    break;
+                }
+            }
+        }
+        t->visited[w] |= discovered;
     }
-    return -1;
+}
+
+// Function to run one level through a task and append what it discovered
+static long long runLevel(Traversal* t, ParallelTask task, int begin, int end, int numThreads) {
+    TraversalLevel level;
+    level.t = t;
+    level.begin = begin;
+    level.end = end;
+    level.found = (int**)calloc((size_t)numThreads, sizeof(int*));
+    level.foundCount = (int*)calloc((size_t)numThreads, sizeof(int));
+    level.foundRoads = (long long*)calloc((size_t)numThreads, sizeof(long long));
+    
+    if (numThreads > 1) {
+        runParallel(numThreads, task, &level);
+        t->parallelLevels++;
+    } else {
+        task(0, 1, &level);
+    }
+    
+    long long roads = 0;
+    for (int thread = 0; thread < numThreads; thread++) {
+        traversalAppend(t, level.found[thread], level.foundCount[thread]);
+        roads += level.foundRoads[thread];
+        free(level.found[thread]);
+    }
+    free(level.found);
+    free(level.foundCount);
+    free(level.foundRoads);
+    return roads;
+}
+
+// Function to run a BFS from source over the open roads
+// Intersections already visited by an earlier run on the same traversal are
+// skipped. Stops as soon as target is discovered (target < 0: never) and
+// returns its distance, or -1 if it is unreachable; order[] then holds the
+// intersections visited by this run and parent[] their BFS tree.
+int traversalRun(Traversal* t, int source, int target) {
+    const RoadCSR* graph = t->graph;
+    int n = t->numVertices;
+    t->orderCount = 0;
+    t->bottomUpLevels = 0;
+    t->parallelLevels = 0;
+    
+    bitSet(t->visited, source);
+    t->parent[source] = -1;
+    traversalAppend(t, &source, 1);
+    t->unexploredRoads -= roadCount(graph, source);
+    if (source == target) return 0;
+    
+    long long frontierRoads = roadCount(graph, source);
+    int begin = 0, end = 1, depth = 0;
+    bool bottomUp = false;
+    
+    while (begin < end) {
+        int frontierSize = end - begin;
+        if (!bottomUp && n >= TRAVERSAL_DIRECTION_MIN && frontierRoads > t->unexploredRoads / TRAVERSAL_ALPHA) {
+            bottomUp = true;
+        } else if (bottomUp && frontierSize < n / TRAVERSAL_BETA) {
+            bottomUp = false;
+        }
+        
+        long long nextRoads = 0;
+        if (bottomUp) {
+            memset(t->frontierBits, 0, (((size_t)n + 63) / 64) * sizeof(uint64_t));
+            for (int i = begin; i < end; i++) bitSet(t->frontierBits, t->order[i]);
+            int threads = n >= TRAVERSAL_PARALLEL_MIN ? t->numThreads : 1;
+            nextRoads = runLevel(t, bottomUpTask, begin, end, threads);
+            t->bottomUpLevels++;
+        } else if (frontierRoads >= TRAVERSAL_PARALLEL_MIN && t->numThreads > 1) {
+            nextRoads = runLevel(t, topDownTask, begin, end, t->numThreads);
+        } else {
+            // Sequential top-down: queue order, and stop the moment target appears
+            for (int i = begin; i < end; i++) {
+                int u = t->order[i];
+                for (int e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+                    int v = graph->targets[e];
+                    if (bitTest(t->blockedRoads, graph->roadIds[e]) || bitTest(t->visited, v)) continue;
+                    bitSet(t->visited, v);
+                    t->parent[v] = u;
+                    traversalAppend(t, &v, 1);
+                    nextRoads += roadCount(graph, v);
+                    if (v == target) {
+                        t->unexploredRoads -= nextRoads;
+                        return depth + 1;
+                    }
+                }
+            }
+        }
+        
+        t->unexploredRoads -= nextRoads;
+        frontierRoads = nextRoads;
+        depth++;
+        if (target >= 0 && bitTest(t->visited, target)) return depth;
+        begin = end;
+        end = t->orderCount;
+    }
+    return target >= 0 ? -1 : depth;
+}
+
+// ===================== CACHED REACHABILITY =====================
+//
+// Every change to the road network (addIntersection, addRoad, and a
+// blockRoad/unblockRoad that actually flips a road) bumps the city's road
+// status epoch. Component labels are computed with the traversal engine
+// the first time they are needed in an epoch and reused until the next
+// bump, so between closures a reachability query is two array reads.
+
+// A reachability query for isReachableBatch
+typedef struct IntersectionPair {
+    int start;
+    int end;
+} IntersectionPair;
+
+// Function to return the component label of every intersection for the
+// current road status epoch, recomputing them only if the epoch moved on
+const int* componentLabels(CityGraph* city) {
+    ComponentLabels* labels = &city->labels;
+    if (labels->label != NULL && labels->epoch == city->roadStatusEpoch) return labels->label;
+    
+    int n = city->numIntersections;
+    if (labels->capacity < n) {
+        labels->capacity = n;
+        labels->label = (int*)realloc(labels->label, (size_t)n * sizeof(int));
+    }
+    
+    Traversal traversal;
+    traversalInit(&traversal, city);
+    labels->numComponents = 0;
+    for (int i = 0; i < n; i++) {
+        if (bitTest(traversal.visited, i)) continue;
+        traversalRun(&traversal, i, -1);
+        for (int j = 0; j < traversal.orderCount; j++) labels->label[traversal.order[j]] = labels->numComponents;
+        labels->numComponents++;
+    }
+    traversalFree(&traversal);
+    labels->epoch = city->roadStatusEpoch;
+    return labels->label;
+}
+
+// Function to check reachability against the cached component labels
+// Silent, and O(1) once the labels of the current epoch exist.
+bool isReachableCached(CityGraph* city, int start, int end) {
+    const int* label = componentLabels(city);
+    return label[start] == label[end];
+}
+
+// Function to answer many reachability queries at once; reachable[i] is
+// set for pairs[i]. Returns how many of the pairs are reachable.
+int isReachableBatch(CityGraph* city, const IntersectionPair* pairs, int count, bool* reachable) {
+    const int* label = componentLabels(city);
+    int reachableCount = 0;
+    for (int i = 0; i < count; i++) {
+        reachable[i] = label[pairs[i].start] == label[pairs[i].end];
+        reachableCount += reachable[i];
+    }
+    return reachableCount;
 }
 
 // Function to print the city graph
@@ -155,7 +1295,7 @@ void printCityGraph(CityGraph* city) {
         } else {
             while (current != NULL) {
                 char status[20];
-                if (city->roadBlocked[current->roadId]) {
+                if (isRoadBlocked(city, current->roadId)) {
                     strcpy(status, "(BLOCKED)");
                 } else {
                     strcpy(status, "(OPEN)");
@@ -173,151 +1313,199 @@ void printCityGraph(CityGraph* city) {
 bool isReachable(CityGraph* city, int start, int end) {
     if (start == end) return true;
     
-    bool visited[MAX_INTERSECTIONS] = {false};
-    Queue queue;
-    initializeQueue(&queue);
+    Traversal traversal;
+    traversalInit(&traversal, city);
+    bool found = traversalRun(&traversal, start, end) >= 0;
     
-    visited[start] = true;
-    enqueue(&queue, start);
-    
-    printf("BFS Traversal for reachability from %d to %d: ", start, end);
-    
-    while (!isQueueEmpty(&queue)) {
-        int current = dequeue(&queue);
-        printf("%d ", current);
-        
-        Road* road = city->intersections[current].roads;
-        while (road != NULL) {
-            int neighbor = road->destination;
-            
-            // Check if road is not blocked and neighbor not visited
-            if (!city->roadBlocked[road->roadId] && !visited[neighbor]) {
-                if (neighbor == end) {
-                    printf("-> %d (FOUND!)\n", neighbor);
-                    return true;
-                }
-                
-                visited[neighbor] = true;
-                enqueue(&queue, neighbor);
-            }
-            road = road->next;
+    // Print the intersections expanded before end was discovered
+    CITY_LOG("BFS Traversal for reachability from %d to %d: ", start, end);
+    if (!quietMode) {
+        int discoverer = found ? traversal.parent[end] : -1;
+        for (int i = 0; i < traversal.orderCount; i++) {
+            int current = traversal.order[i];
+            if (current == end) continue;
+            printf("%d ", current);
+            if (current == discoverer) break;
         }
     }
+    if (found) {
+        CITY_LOG("-> %d (FOUND!)\n", end);
+    } else {
+        CITY_LOG("(NOT REACHABLE)\n");
+    }
     
-    printf("(NOT REACHABLE)\n");
-    return false;
+    traversalFree(&traversal);
+    return found;
 }
 
 // BFS to find shortest path (minimum number of roads)
 int findShortestPath(CityGraph* city, int start, int end) {
     if (start == end) return 0;
     
-    bool visited[MAX_INTERSECTIONS] = {false};
-    int distance[MAX_INTERSECTIONS];
-    int parent[MAX_INTERSECTIONS];
-    Queue queue;
-    initializeQueue(&queue);
+    Traversal traversal;
+    traversalInit(&traversal, city);
+    int distance = traversalRun(&traversal, start, end);
     
-    // Initialize distances and parents
-    for (int i = 0; i < city->numIntersections; i++) {
-        distance[i] = INT_MAX;
-        parent[i] = -1;
+    CITY_LOG("BFS for shortest path from %d to %d:\n", start, end);
+    CITY_LOG("Traversal order: ");
+    if (!quietMode) {
+        for (int i = 0; i < traversal.orderCount; i++) {
+            printf("%d ", traversal.order[i]);
+            if (traversal.order[i] == end) break;
+        }
     }
     
-    visited[start] = true;
-    distance[start] = 0;
-    enqueue(&queue, start);
+    // Print the path if destination is reachable
+    if (distance >= 0) {
+        CITY_LOG("(DESTINATION REACHED!)\n");
+        CITY_LOG("Shortest path: ");
+        int* path = (int*)malloc(((size_t)distance + 1) * sizeof(int));
+        int pathLength = 0;
+        int current = end;
+        
+        while (current != -1) {
+            path[pathLength++] = current;
+            current = traversal.parent[current];
+        }
+        
+        for (int i = pathLength - 1; i >= 0; i--) {
+            CITY_LOG("%d", path[i]);
+            if (i > 0) CITY_LOG(" -> ");
+        }
+        CITY_LOG("\n");
+        free(path);
+    }
     
-    printf("BFS for shortest path from %d to %d:\n", start, end);
-    printf("Traversal order: ");
+    traversalFree(&traversal);
+    return distance; // -1 if no path found
+}
+
+// Function to find the shortest path with a bidirectional BFS
+// Grows one BFS from start and one from end, each step expanding a whole
+// level of whichever frontier is smaller. The first level that reaches a
+// node already seen by the other side fixes the distance (the best meeting
+// road over that level), so a cross-town trip explores two small balls
+// instead of one large one. Same result and path printout as findShortestPath.
+int findShortestPathBidirectional(CityGraph* city, int start, int end) {
+    if (start == end) return 0;
     
-    while (!isQueueEmpty(&queue)) {
-        int current = dequeue(&queue);
-        printf("%d ", current);
-        
-        if (current == end) {
-            printf("(DESTINATION REACHED!)\n");
-            break;
+    const RoadCSR* graph = cityAdjacency(city);
+    int n = city->numIntersections;
+    int* distance[2];
+    int* parent[2];
+    int* frontier[2];
+    int frontierSize[2] = {1, 1};
+    int* storage = (int*)malloc(7 * (size_t)n * sizeof(int));   // One block for all seven arrays
+    for (int side = 0; side < 2; side++) {
+        distance[side] = storage + (size_t)(3 * side) * n;
+        parent[side] = distance[side] + n;
+        frontier[side] = parent[side] + n;
+        for (int i = 0; i < n; i++) {
+            distance[side][i] = -1;
+            parent[side][i] = -1;
         }
+    }
+    int* next = storage + 6 * (size_t)n;
+    distance[0][start] = 0;
+    distance[1][end] = 0;
+    frontier[0][0] = start;
+    frontier[1][0] = end;
+    
+    CITY_LOG("Bidirectional BFS for shortest path from %d to %d:\n", start, end);
+    CITY_LOG("Traversal order: ");
+    
+    int best = INT_MAX;
+    int meetStart = -1, meetEnd = -1;   // Meeting road: start side -> end side
+    while (frontierSize[0] > 0 && frontierSize[1] > 0 && best == INT_MAX) {
+        int side = frontierSize[0] <= frontierSize[1] ? 0 : 1;
+        int other = 1 - side;
+        int nextSize = 0;
         
-        Road* road = city->intersections[current].roads;
-        while (road != NULL) {
-            int neighbor = road->destination;
+        for (int f = 0; f < frontierSize[side]; f++) {
+            int current = frontier[side][f];
+            CITY_LOG("%d ", current);
             
-            // Check if road is not blocked and neighbor not visited
-            if (!city->roadBlocked[road->roadId] && !visited[neighbor]) {
-                visited[neighbor] = true;
-                distance[neighbor] = distance[current] + 1;
-                parent[neighbor] = current;
-                enqueue(&queue, neighbor);
+            for (int e = graph->offsets[current]; e < graph->offsets[current + 1]; e++) {
+                if (isRoadBlocked(city, graph->roadIds[e])) continue;
+                int neighbor = graph->targets[e];
+                
+                if (distance[other][neighbor] != -1) {
+                    int total = distance[side][current] + 1 + distance[other][neighbor];
+                    if (total < best) {
+                        best = total;
+                        meetStart = side == 0 ? current : neighbor;
+                        meetEnd = side == 0 ? neighbor : current;
+                    }
+                }
+                if (distance[side][neighbor] == -1) {
+                    distance[side][neighbor] = distance[side][current] + 1;
+                    parent[side][neighbor] = current;
+                    next[nextSize++] = neighbor;
+                }
             }
-            road = road->next;
         }
+        
+        int* expanded = frontier[side];
+        frontier[side] = next;
+        next = expanded;
+        frontierSize[side] = nextSize;
     }
     
-    // Print the path if destination is reachable
-    if (distance[end] != INT_MAX) {
-        printf("Shortest path: ");
-        int path[MAX_INTERSECTIONS];
-        int pathLength = 0;
-        int current = end;
+    if (best != INT_MAX) {
+        CITY_LOG("(FRONTIERS MET!)\n");
         
-        while (current != -1) {
+        // start ... meetStart from the forward tree, meetEnd ... end from the backward tree
+        int* path = next;
+        int pathLength = 0;
+        for (int current = meetStart; current != -1; current = parent[0][current]) {
             path[pathLength++] = current;
-            current = parent[current];
         }
-        
-        for (int i = pathLength - 1; i >= 0; i--) {
-            printf("%d", path[i]);
-            if (i > 0) printf(" -> ");
+        for (int i = 0, j = pathLength - 1; i < j; i++, j--) {
+            int temp = path[i];
+            path[i] = path[j];
+            path[j] = temp;
+        }
+        for (int current = meetEnd; current != -1; current = parent[1][current]) {
+            path[pathLength++] = current;
         }
-        printf("\n");
         
-        return distance[end];
+        CITY_LOG("Shortest path: ");
+        for (int i = 0; i < pathLength; i++) {
+            CITY_LOG("%d", path[i]);
+            if (i < pathLength - 1) CITY_LOG(" -> ");
+        }
+        CITY_LOG("\n");
+    } else {
+        CITY_LOG("(NOT REACHABLE)\n");
     }
     
-    return -1; // No path found
+    free(storage);
+    return best != INT_MAX ? best : -1;
 }
 
 // BFS to count connected components
 int countConnectedComponents(CityGraph* city) {
-    bool visited[MAX_INTERSECTIONS] = {false};
+    Traversal traversal;
+    traversalInit(&traversal, city);
     int componentCount = 0;
     
-    printf("=== CONNECTED COMPONENTS ANALYSIS ===\n");
+    CITY_LOG("=== CONNECTED COMPONENTS ANALYSIS ===\n");
     
     for (int i = 0; i < city->numIntersections; i++) {
-        if (!visited[i]) {
+        if (!bitTest(traversal.visited, i)) {
             componentCount++;
-            printf("Component %d: ", componentCount);
             
             // BFS to find all intersections in this component
-            Queue queue;
-            initializeQueue(&queue);
-            
-            visited[i] = true;
-            enqueue(&queue, i);
-            printf("%d ", i);
-            
-            while (!isQueueEmpty(&queue)) {
-                int current = dequeue(&queue);
-                
-                Road* road = city->intersections[current].roads;
-                while (road != NULL) {
-                    int neighbor = road->destination;
-                    
-                    if (!city->roadBlocked[road->roadId] && !visited[neighbor]) {
-                        visited[neighbor] = true;
-                        enqueue(&queue, neighbor);
-                        printf("%d ", neighbor);
-                    }
-                    road = road->next;
-                }
+            traversalRun(&traversal, i, -1);
+            if (!quietMode) {
+                printf("Component %d: ", componentCount);
+                for (int j = 0; j < traversal.orderCount; j++) printf("%d ", traversal.order[j]);
+                printf("\n");
             }
-            printf("\n");
         }
     }
     
+    traversalFree(&traversal);
     return componentCount;
 }
 
@@ -366,6 +1554,241 @@ void runTests(CityGraph* city) {
     printf("After unblocking roads:\n");
     int finalComponents = countConnectedComponents(city);
     printf("Connected components after unblocking: %d\n", finalComponents);
+    
+    // Test 6: Connectivity index and offline replay of a day of closures
+    printf("\nTest 6: Dynamic Connectivity Index\n");
+    printf("Index: 0 -> 4 %s, 1 -> 5 %s, %d components\n",
+           isReachableIndexed(city, 0, 4) ? "YES" : "NO",
+           isReachableIndexed(city, 1, 5) ? "YES" : "NO", countComponentsIndexed(city));
+    
+    ClosureEvent day[] = {
+        {EVENT_BLOCK, 2, 4}, {EVENT_BLOCK, 3, 4}, {EVENT_QUERY_REACHABLE, 0, 4},
+        {EVENT_QUERY_COMPONENTS, 0, 0}, {EVENT_UNBLOCK, 3, 4}, {EVENT_QUERY_REACHABLE, 0, 4},
+        {EVENT_BLOCK, 0, 1}, {EVENT_BLOCK, 0, 2}, {EVENT_QUERY_COMPONENTS, 0, 0},
+    };
+    int numEvents = (int)(sizeof(day) / sizeof(day[0]));
+    int answers[sizeof(day) / sizeof(day[0])];
+    replayClosuresOffline(city, day, numEvents, answers);
+    printf("Offline replay: block 2-4, block 3-4 -> 0 to 4 %s, %d components; ",
+           answers[2] ? "YES" : "NO", answers[3]);
+    printf("unblock 3-4 -> 0 to 4 %s; block 0-1, 0-2 -> %d components\n",
+           answers[5] ? "YES" : "NO", answers[8]);
+    
+    // Test 7: Bidirectional search finds the same distance
+    printf("\nTest 7: Bidirectional Shortest Path\n");
+    int bidirectional = findShortestPathBidirectional(city, 0, 4);
+    printf("Shortest distance from 0 to 4: %d roads\n", bidirectional);
+    
+    // Test 8: Batched reachability from cached component labels
+    printf("\nTest 8: Cached Reachability (epoch-based labels)\n");
+    IntersectionPair trips[] = {{0, 4}, {1, 5}, {3, 0}, {5, 5}};
+    int numTrips = (int)(sizeof(trips) / sizeof(trips[0]));
+    bool reachable[sizeof(trips) / sizeof(trips[0])];
+    isReachableBatch(city, trips, numTrips, reachable);
+    for (int i = 0; i < numTrips; i++) {
+        printf("%d -> %d: %s  ", trips[i].start, trips[i].end, reachable[i] ? "YES" : "NO");
+    }
+    printf("(epoch %llu)\n", city->roadStatusEpoch);
+    blockRoad(city, 2, 4);
+    blockRoad(city, 3, 4);
+    printf("After blocking 2-4 and 3-4: 0 -> 4 %s (epoch %llu)\n",
+           isReachableCached(city, 0, 4) ? "YES" : "NO", city->roadStatusEpoch);
+    unblockRoad(city, 2, 4);
+    unblockRoad(city, 3, 4);
+    printf("After unblocking them: 0 -> 4 %s (epoch %llu)\n",
+           isReachableCached(city, 0, 4) ? "YES" : "NO", city->roadStatusEpoch);
+}
+
+// ===================== BENCHMARKS =====================
+
+#define BENCH_QUERIES 20000
+#define BENCH_UPDATES 100000
+#define BENCH_REACH_QUERIES 1000000
+#define BENCH_DEFAULT_INTERSECTIONS 1000000
+
+// Function to build a side x side street grid
+void buildGridCity(CityGraph* city, int side) {
+    initializeCityGraph(city, side * side);
+    for (int row = 0; row < side; row++) {
+        for (int col = 0; col < side; col++) {
+            int id = row * side + col;
+            if (col + 1 < side) addRoad(city, id, id + 1);
+            if (row + 1 < side) addRoad(city, id, id + side);
+        }
+    }
+}
+
+// Function to build a random road network with the given number of roads
+void buildRandomCity(CityGraph* city, int numIntersections, int numRoads, unsigned long long seed) {
+    initializeCityGraph(city, numIntersections);
+    for (int i = 0; i < numRoads; i++) {
+        int a = (int)(nextRandom(&seed) % (unsigned long long)numIntersections);
+        int b = (int)(nextRandom(&seed) % (unsigned long long)numIntersections);
+        addRoad(city, a, b);
+    }
+}
+
+// Function to time one-sided against bidirectional BFS on random trips
+static void benchmarkShortestPaths(CityGraph* city, const char* name, int trips, unsigned long long seed) {
+    int n = city->numIntersections;
+    int* starts = (int*)malloc((size_t)trips * sizeof(int));
+    int* ends = (int*)malloc((size_t)trips * sizeof(int));
+    int* expected = (int*)malloc((size_t)trips * sizeof(int));
+    seed ^= 0x5DEECE66DULL;   // Trips independent of the random network's roads
+    for (int q = 0; q < trips; q++) {
+        starts[q] = (int)(nextRandom(&seed) % (unsigned long long)n);
+        ends[q] = (int)(nextRandom(&seed) % (unsigned long long)n);
+    }
+    
+    double begin = nowSeconds();
+    for (int q = 0; q < trips; q++) expected[q] = findShortestPath(city, starts[q], ends[q]);
+    double oneSided = nowSeconds() - begin;
+    
+    int mismatches = 0;
+    begin = nowSeconds();
+    for (int q = 0; q < trips; q++) {
+        mismatches += findShortestPathBidirectional(city, starts[q], ends[q]) != expected[q];
+    }
+    double bidirectional = nowSeconds() - begin;
+    
+    printf("%-22s %8d %8d %14.2f %14.2f %8.1fx%s\n", name, n, city->numRoads,
+           oneSided * 1e6 / trips, bidirectional * 1e6 / trips,
+           oneSided / bidirectional, mismatches ? "  MISMATCH" : "");
+    free(starts);
+    free(ends);
+    free(expected);
+}
+
+// Function to time a feed of random block/unblock updates (road lookup,
+// blocked bit and connectivity index) and the road lookup on its own
+static void benchmarkClosures(CityGraph* city, const char* name, unsigned long long seed) {
+    const RoadCSR* graph = cityAdjacency(city);
+    int* ends = (int*)malloc(2 * BENCH_UPDATES * sizeof(int));
+    int numUpdates = 0;
+    while (numUpdates < BENCH_UPDATES) {
+        int v = (int)(nextRandom(&seed) % (unsigned long long)city->numIntersections);
+        int degree = graph->offsets[v + 1] - graph->offsets[v];
+        if (degree == 0) continue;
+        ends[2 * numUpdates] = v;
+        ends[2 * numUpdates + 1] = graph->targets[graph->offsets[v] + (int)(nextRandom(&seed) % (unsigned)degree)];
+        numUpdates++;
+    }
+    
+    long long found = 0;
+    double begin = nowSeconds();
+    for (int i = 0; i < numUpdates; i++) found += findRoadId(city, ends[2 * i], ends[2 * i + 1]) >= 0;
+    double lookup = nowSeconds() - begin;
+    
+    begin = nowSeconds();
+    for (int i = 0; i < numUpdates; i++) {
+        int roadId = findRoadId(city, ends[2 * i], ends[2 * i + 1]);
+        if (isRoadBlocked(city, roadId)) {
+            unblockRoad(city, ends[2 * i], ends[2 * i + 1]);
+        } else {
+            blockRoad(city, ends[2 * i], ends[2 * i + 1]);
+        }
+    }
+    double updates = nowSeconds() - begin;
+    
+    begin = nowSeconds();
+    int components = countConnectedComponents(city);
+    double traversal = nowSeconds() - begin;
+    
+    printf("%-22s %12.1f %12.2f %14.1f %10d%s\n", name, lookup * 1e9 / numUpdates, updates * 1e6 / numUpdates,
+           traversal * 1e3, components,
+           found != numUpdates || components != countComponentsIndexed(city) ? "  MISMATCH" : "");
+    free(ends);
+}
+
+// Function to time reachability queries: BFS, the dynamic connectivity
+// index, and cached labels one at a time and batched
+static void benchmarkReachability(CityGraph* city, const char* name, int trips, unsigned long long seed) {
+    int n = city->numIntersections;
+    IntersectionPair* pairs = (IntersectionPair*)malloc(BENCH_REACH_QUERIES * sizeof(IntersectionPair));
+    bool* batched = (bool*)malloc(BENCH_REACH_QUERIES * sizeof(bool));
+    seed ^= 0xC0FFEEULL;
+    for (int q = 0; q < BENCH_REACH_QUERIES; q++) {
+        pairs[q].start = (int)(nextRandom(&seed) % (unsigned long long)n);
+        pairs[q].end = (int)(nextRandom(&seed) % (unsigned long long)n);
+    }
+    int mismatches = 0;
+    
+    double begin = nowSeconds();
+    for (int q = 0; q < trips; q++) mismatches += isReachable(city, pairs[q].start, pairs[q].end) !=
+                                                  isReachableIndexed(city, pairs[q].start, pairs[q].end);
+    double bfs = nowSeconds() - begin;
+    
+    begin = nowSeconds();
+    for (int q = 0; q < BENCH_REACH_QUERIES; q++) batched[q] = isReachableIndexed(city, pairs[q].start, pairs[q].end);
+    double indexed = nowSeconds() - begin;
+    
+    city->roadStatusEpoch++;   // Time a fresh labelling
+    begin = nowSeconds();
+    componentLabels(city);
+    double labelling = nowSeconds() - begin;
+    
+    begin = nowSeconds();
+    for (int q = 0; q < BENCH_REACH_QUERIES; q++) {
+        mismatches += isReachableCached(city, pairs[q].start, pairs[q].end) != batched[q];
+    }
+    double cached = nowSeconds() - begin;
+    
+    bool* expected = batched;
+    batched = (bool*)malloc(BENCH_REACH_QUERIES * sizeof(bool));
+    begin = nowSeconds();
+    isReachableBatch(city, pairs, BENCH_REACH_QUERIES, batched);
+    double batch = nowSeconds() - begin;
+    mismatches += memcmp(batched, expected, BENCH_REACH_QUERIES * sizeof(bool)) != 0;
+    
+    printf("%-22s %10.1f %11.1f %12.2f %11.1f %11.1f%s\n", name, bfs * 1e6 / trips,
+           indexed * 1e9 / BENCH_REACH_QUERIES, labelling * 1e3, cached * 1e9 / BENCH_REACH_QUERIES,
+           batch * 1e9 / BENCH_REACH_QUERIES, mismatches ? "  MISMATCH" : "");
+    free(pairs);
+    free(batched);
+    free(expected);
+}
+
+// Function to benchmark shortest-path search and the closure feed on
+// grid-like and random networks of about numIntersections intersections
+void runBenchmarks(unsigned long long seed, int numIntersections) {
+    int side = 1;
+    while ((long long)(side + 1) * (side + 1) <= numIntersections) side++;
+    long long scaled = 20000000LL / numIntersections;
+    int trips = scaled < 50 ? 50 : scaled > BENCH_QUERIES ? BENCH_QUERIES : (int)scaled;
+    
+    bool wasQuiet = quietMode;
+    quietMode = true;
+    CityGraph* networks[2];
+    const char* names[2];
+    char gridName[64];
+    
+    networks[0] = (CityGraph*)malloc(sizeof(CityGraph));
+    buildGridCity(networks[0], side);
+    snprintf(gridName, sizeof(gridName), "grid %dx%d", side, side);
+    names[0] = gridName;
+    networks[1] = (CityGraph*)malloc(sizeof(CityGraph));
+    buildRandomCity(networks[1], numIntersections, 2 * numIntersections, seed);
+    names[1] = "random (avg degree 4)";
+    
+    printf("=== SHORTEST PATH BENCHMARK (%d random trips per network, seed %llu) ===\n", trips, seed);
+    printf("%-22s %8s %8s %14s %14s %9s\n", "Network", "Nodes", "Roads",
+           "one-sided (us)", "bidir (us)", "speedup");
+    for (int i = 0; i < 2; i++) benchmarkShortestPaths(networks[i], names[i], trips, seed);
+    
+    printf("\n=== ROAD CLOSURE FEED (%d random block/unblock updates) ===\n", BENCH_UPDATES);
+    printf("%-22s %12s %12s %14s %10s\n", "Network", "lookup (ns)", "update (us)", "components (ms)", "count");
+    for (int i = 0; i < 2; i++) benchmarkClosures(networks[i], names[i], seed);
+    
+    printf("\n=== REACHABILITY QUERIES (%d random pairs; BFS on the first %d) ===\n", BENCH_REACH_QUERIES, trips);
+    printf("%-22s %10s %11s %12s %11s %11s\n", "Network", "BFS (us)", "index (ns)", "labels (ms)",
+           "cached (ns)", "batch (ns)");
+    for (int i = 0; i < 2; i++) benchmarkReachability(networks[i], names[i], trips, seed);
+    
+    for (int i = 0; i < 2; i++) {
+        freeCityGraph(networks[i]);
+        free(networks[i]);
+    }
+    quietMode = wasQuiet;
 }
 
 // Interactive menu system
@@ -382,9 +1805,37 @@ void displayMenu() {
     printf("Choose an option: ");
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     CityGraph city;
     
+    if (argc > 1) {
+        bool bench = false;
+        unsigned long long seed = 1;
+        int numIntersections = BENCH_DEFAULT_INTERSECTIONS;
+        for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--bench") == 0) {
+                bench = true;
+                if (i + 1 < argc && argv[i + 1][0] != '-') seed = strtoull(argv[++i], NULL, 10);
+            } else if (strcmp(argv[i], "--nodes") == 0 && i + 1 < argc) {
+                numIntersections = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+                traversalThreads = atoi(argv[++i]);
+            } else {
+                bench = false;
+                break;
+            }
+        }
+        if (bench) {
+            if (numIntersections < 4) numIntersections = 4;
+            runBenchmarks(seed, numIntersections);
+            return 0;
+        }
+        printf("Usage: %s                                    interactive menu\n", argv[0]);
+        printf("       %s --bench [S] [--nodes N] [--threads T]  time one-sided vs bidirectional BFS and\n", argv[0]);
+        printf("                                                  the closure feed (seed S, ~N intersections)\n");
+        return 1;
+    }
+    
     printf("=== SMART CITY NAVIGATION SYSTEM ===\n");
     printf("Graph-based Road Network Analysis\n\n");
     
@@ -500,5 +1951,6 @@ int main() {
         }
     } while (choice != 8);
     
+    freeCityGraph(&city);
     return 0;
 }
\ No newline at end of file
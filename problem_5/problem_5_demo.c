@@ -2,6 +2,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "../common/arena.h"
+
 #define MAX_CHAR 128
 #define MAX_LEN 100
 
@@ -21,9 +23,9 @@ int isVowel(char ch) {
     return ch == 'a' || ch == 'e' || ch == 'i' || ch == 'o' || ch == 'u';
 }
 
-// Create a new heap node
-MinHeapNode* newNode(char data, unsigned freq) {
-    MinHeapNode* node = (MinHeapNode*)malloc(sizeof(MinHeapNode));
+// Create a new heap node in the tree's arena
+MinHeapNode* newNode(Arena* arena, char data, unsigned freq) {
+    MinHeapNode* node = (MinHeapNode*)arenaAlloc(arena, sizeof(MinHeapNode), _Alignof(MinHeapNode));
     node->data = data;
     node->freq = freq;
     node->left = node->right = NULL;
@@ -55,11 +57,11 @@ void minHeapify(MinHeap* heap, int i) {
 }
 
 // Build a min-heap
-MinHeap* buildMinHeap(char data[], int freq[], int size) {
+MinHeap* buildMinHeap(Arena* arena, char data[], int freq[], int size) {
     MinHeap* heap = (MinHeap*)malloc(sizeof(MinHeap));
     heap->size = size;
     for (int i = 0; i < size; i++)
-        heap->array[i] = newNode(data[i], freq[i]);
+        heap->array[i] = newNode(arena, data[i], freq[i]);
 
     for (int i = (size - 2) / 2; i >= 0; i--)
         minHeapify(heap, i);
@@ -88,21 +90,24 @@ void insertHeap(MinHeap* heap, MinHeapNode* node) {
 }
 
 // Build the Huffman tree
-MinHeapNode* buildHuffmanTree(char data[], int freq[], int size) {
-    MinHeap* heap = buildMinHeap(data, freq, size);
+// All tree nodes come from arena; release the arena to free the whole tree.
+MinHeapNode* buildHuffmanTree(Arena* arena, char data[], int freq[], int size) {
+    MinHeap* heap = buildMinHeap(arena, data, freq, size);
 
     while (heap->size > 1) {
         MinHeapNode* left = extractMin(heap);
         MinHeapNode* right = extractMin(heap);
 
-        MinHeapNode* top = newNode('$', left->freq + right->freq);
+        MinHeapNode* top = newNode(arena, '$', left->freq + right->freq);
         top->left = left;
         top->right = right;
 
         insertHeap(heap, top);
     }
 
-    return extractMin(heap);
+    MinHeapNode* root = extractMin(heap);
+    free(heap);
+    return root;
 }
 
 // Generate Huffman codes
@@ -148,7 +153,9 @@ int main() {
     }
 
     // Build Huffman tree
-    MinHeapNode* root = buildHuffmanTree(symbols, freq, symCount);
+    Arena treeArena;
+    arenaInit(&treeArena, 0);
+    MinHeapNode* root = buildHuffmanTree(&treeArena, symbols, freq, symCount);
 
     // Generate codes
     char codes[MAX_CHAR][MAX_CHAR];
@@ -168,5 +175,6 @@ int main() {
     }
     printf("\n");
 
+    arenaRelease(&treeArena);
     return 0;
 }